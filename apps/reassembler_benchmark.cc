@@ -0,0 +1,115 @@
+#include "stream_reassembler.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using namespace std::chrono;
+
+constexpr size_t len = 100 * 1024 * 1024;
+constexpr size_t capacity = 64000;
+constexpr size_t segment_size = 1452;
+
+enum class Order { InOrder, Reversed, Overlapping };
+
+// Cut one window of the stream, starting at `start`, into segments in the given order.
+vector<pair<size_t, size_t>> window_segments(const size_t start, const size_t end, const Order order, mt19937 &rd) {
+    vector<pair<size_t, size_t>> segments;
+    for (size_t index = start; index < end; index += segment_size) {
+        segments.emplace_back(index, min(segment_size, end - index));
+    }
+    if (order == Order::Reversed) {
+        reverse(segments.begin(), segments.end());
+    } else if (order == Order::Overlapping) {
+        // every segment is sent twice, widened to overlap its neighbours, in a shuffled order
+        const size_t n_segments = segments.size();
+        for (size_t i = 0; i < n_segments; ++i) {
+            const auto [index, size] = segments[i];
+            const size_t widened_start = index >= start + segment_size / 2 ? index - segment_size / 2 : start;
+            segments.emplace_back(widened_start, min(index + size + segment_size / 2, end) - widened_start);
+        }
+        shuffle(segments.begin(), segments.end(), rd);
+    }
+    return segments;
+}
+
+// With `by_reference`, segments are pushed as slices of one Buffer into a Chunked stream.
+void main_loop(const Order order, const bool by_reference) {
+    mt19937 rd{42};
+    string string_to_send(len, 'x');
+    for (auto &ch : string_to_send) {
+        ch = rd();
+    }
+
+    const Buffer buffer_to_send{string(string_to_send)};
+    StreamReassembler reassembler{capacity, by_reference ? ByteStream::Storage::Chunked : ByteStream::Storage::Ring};
+    string string_received;
+    string_received.reserve(len);
+
+    nanoseconds::rep duration = 0;
+
+    for (size_t start = 0; start < len; start += capacity) {
+        const size_t end = min(start + capacity, len);
+
+        // cut the segments before starting the clock, so only the reassembler is timed
+        vector<pair<string, size_t>> strings;
+        vector<pair<Buffer, size_t>> buffers;
+        for (const auto &[index, size] : window_segments(start, end, order, rd)) {
+            if (by_reference) {
+                Buffer segment = buffer_to_send;
+                segment.remove_prefix(index);
+                segment.remove_suffix(len - index - size);
+                buffers.emplace_back(move(segment), index);
+            } else {
+                strings.emplace_back(string_to_send.substr(index, size), index);
+            }
+        }
+
+        const auto first_time = high_resolution_clock::now();
+        for (auto &[segment, index] : buffers) {
+            const size_t size = segment.size();
+            reassembler.push_substring(move(segment), index, index + size == len);
+        }
+        for (const auto &[segment, index] : strings) {
+            reassembler.push_substring(segment, index, index + segment.size() == len);
+        }
+        const auto final_time = high_resolution_clock::now();
+        duration += duration_cast<nanoseconds>(final_time - first_time).count();
+
+        ByteStream &output = reassembler.stream_out();
+        string_received.append(output.read(output.buffer_size()));
+    }
+
+    if (not reassembler.stream_out().eof() or string_received != string_to_send) {
+        throw runtime_error("strings pushed vs. reassembled don't match");
+    }
+
+    const auto gigabits_per_second = len * 8.0 / double(duration);
+
+    cout << fixed << setprecision(2);
+    cout << "StreamReassembler throughput " << (by_reference ? "(Buffer) " : "(string) ")
+         << (order == Order::InOrder ? "in order:    " : order == Order::Reversed ? "reversed:    " : "overlapping: ")
+         << gigabits_per_second << " Gbit/s\n";
+}
+
+int main() {
+    try {
+        for (const bool by_reference : {false, true}) {
+            main_loop(Order::InOrder, by_reference);
+            main_loop(Order::Reversed, by_reference);
+            main_loop(Order::Overlapping, by_reference);
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -9,6 +9,7 @@
 #include <random>
 #include <string>
 #include <tuple>
+#include <utility>
 
 using namespace std;
 
@@ -26,7 +27,11 @@ static void show_usage(const char *argv0, const char *msg) {
          << "   -w <winsz>      Use a window of <winsz> bytes                   " << TCPConfig::MAX_PAYLOAD_SIZE
          << "\n\n"
 
-         << "   -t <tmout>      Set rt_timeout to tmout                         " << TCPConfig::TIMEOUT_DFLT << "\n\n"
+         << "   -t <tmout>      Set rt_timeout to tmout                         " << TCPConfig::TIMEOUT_DFLT << "\n"
+         << "   -R              Adapt rt_timeout to the round-trip time         (fixed)\n\n"
+
+         << "   -c <algo>       Use congestion control <algo>: none, newreno,   none\n"
+         << "                   cubic, bbr, or ledbat (to yield to other flows)\n\n"
 
          << "   -Lu <loss>      Set uplink loss to <rate> (float in 0..1)       (no loss)\n"
          << "   -Ld <loss>      Set downlink loss to <rate> (float in 0..1)     (no loss)\n\n"
@@ -46,6 +51,23 @@ static void check_argc(int argc, char **argv, int curr, const char *err) {
     }
 }
 
+static TCPConfig::CongestionControl get_congestion_control(char **argv, const char *name) {
+    const pair<const char *, TCPConfig::CongestionControl> algorithms[] = {
+        {"none", TCPConfig::CongestionControl::None},
+        {"newreno", TCPConfig::CongestionControl::NewReno},
+        {"cubic", TCPConfig::CongestionControl::Cubic},
+        {"bbr", TCPConfig::CongestionControl::BBR},
+        {"ledbat", TCPConfig::CongestionControl::LEDBAT},
+    };
+    for (const auto &[algorithm_name, algorithm] : algorithms) {
+        if (strcmp(algorithm_name, name) == 0) {
+            return algorithm;
+        }
+    }
+    show_usage(argv[0], std::string("ERROR: unknown congestion control " + std::string(name)).c_str());
+    exit(1);
+}
+
 static tuple<TCPConfig, FdAdapterConfig, bool> get_config(int argc, char **argv) {
     TCPConfig c_fsm{};
     FdAdapterConfig c_filt{};
@@ -68,6 +90,15 @@ static tuple<TCPConfig, FdAdapterConfig, bool> get_config(int argc, char **argv)
             c_fsm.rt_timeout = strtol(argv[curr + 1], nullptr, 0);
             curr += 2;
 
+        } else if (strncmp("-R", argv[curr], 3) == 0) {
+            c_fsm.adaptive_rto = true;
+            curr += 1;
+
+        } else if (strncmp("-c", argv[curr], 3) == 0) {
+            check_argc(argc, argv, curr, "ERROR: -c requires one argument.");
+            c_fsm.congestion_control = get_congestion_control(argv, argv[curr + 1]);
+            curr += 2;
+
         } else if (strncmp("-Lu", argv[curr], 3) == 0) {
             check_argc(argc, argv, curr, "ERROR: -Lu requires one argument.");
             float lossrate = strtof(argv[curr + 1], nullptr);
@@ -13,6 +13,8 @@ add_test(NAME t_recv_window          COMMAND recv_window)
 add_test(NAME t_recv_reorder         COMMAND recv_reorder)
 add_test(NAME t_recv_close           COMMAND recv_close)
 add_test(NAME t_recv_special         COMMAND recv_special)
+add_test(NAME t_recv_memory_pressure COMMAND recv_memory_pressure)
+add_test(NAME t_recv_autotune        COMMAND recv_autotune)
 
 add_test(NAME t_send_connect         COMMAND send_connect)
 add_test(NAME t_send_transmit        COMMAND send_transmit)
@@ -21,6 +23,12 @@ add_test(NAME t_send_window          COMMAND send_window)
 add_test(NAME t_send_ack             COMMAND send_ack)
 add_test(NAME t_send_close           COMMAND send_close)
 add_test(NAME t_send_extra           COMMAND send_extra)
+add_test(NAME t_send_autotune        COMMAND send_autotune)
+add_test(NAME t_send_congestion      COMMAND send_congestion)
+add_test(NAME t_send_bbr             COMMAND send_bbr)
+add_test(NAME t_send_ledbat          COMMAND send_ledbat)
+add_test(NAME t_send_pacing          COMMAND send_pacing)
+add_test(NAME t_send_rto             COMMAND send_rto)
 
 add_test(NAME t_strm_reassem_single      COMMAND fsm_stream_reassembler_single)
 add_test(NAME t_strm_reassem_seq         COMMAND fsm_stream_reassembler_seq)
@@ -30,12 +38,20 @@ add_test(NAME t_strm_reassem_many        COMMAND fsm_stream_reassembler_many)
 add_test(NAME t_strm_reassem_overlapping COMMAND fsm_stream_reassembler_overlapping)
 add_test(NAME t_strm_reassem_win         COMMAND fsm_stream_reassembler_win)
 add_test(NAME t_strm_reassem_cap         COMMAND fsm_stream_reassembler_cap)
+add_test(NAME t_strm_reassem_buffers     COMMAND fsm_stream_reassembler_buffers)
+add_test(NAME t_strm_reassem_memory      COMMAND fsm_stream_reassembler_memory)
 
 add_test(NAME t_byte_stream_construction COMMAND byte_stream_construction)
 add_test(NAME t_byte_stream_one_write    COMMAND byte_stream_one_write)
 add_test(NAME t_byte_stream_two_writes   COMMAND byte_stream_two_writes)
 add_test(NAME t_byte_stream_capacity     COMMAND byte_stream_capacity)
 add_test(NAME t_byte_stream_many_writes  COMMAND byte_stream_many_writes)
+add_test(NAME t_byte_stream_views        COMMAND byte_stream_views)
+add_test(NAME t_byte_stream_chunked      COMMAND byte_stream_chunked)
+add_test(NAME t_byte_stream_fd           COMMAND byte_stream_fd)
+add_test(NAME t_byte_stream_prepare      COMMAND byte_stream_prepare)
+add_test(NAME t_byte_stream_watermarks   COMMAND byte_stream_watermarks)
+add_test(NAME t_byte_stream_find         COMMAND byte_stream_find)
 
 add_test(NAME t_webget               COMMAND "${PROJECT_SOURCE_DIR}/tests/webget_t.sh")
 
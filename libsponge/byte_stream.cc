@@ -1,5 +1,8 @@
 #include "byte_stream.hh"
 
+#include "util.hh"
+
+#include <cstring>
 #include <iostream>
 
 // For Lab 0, please replace with a real implementation that passes the
@@ -7,8 +10,15 @@
 
 using namespace std;
 
-ByteStream::ByteStream(const size_t capacity) :
-  buffer_(vector<char>(capacity)),
+ByteStream::ByteStream(const size_t capacity, const Storage storage) :
+  storage_(storage),
+  buffer_(),
+  buffer_alloc_size_(0),
+  chunks_(),
+  mirror_(),
+  pending_(),
+  prepared_size_(0),
+  staged_size_(0),
   capacity_(capacity),
   read_off_(0),
   write_off_(0),
@@ -16,49 +26,377 @@ ByteStream::ByteStream(const size_t capacity) :
   total_nread_(0),
   total_nwrite_(0),
   input_ended_(false),
-  error_(false) {}
+  error_(false),
+  low_watermark_(0),
+  high_watermark_(0),
+  on_low_watermark_(),
+  on_high_watermark_() {
+  if (storage_ == Storage::Mirrored) {
+    mirror_.emplace(round_up_pow2(capacity_), capacity_ >= HUGE_PAGE_MIN_CAPACITY);
+  }
+}
 
 size_t ByteStream::write(const string &data) {
+  if (storage_ != Storage::Chunked) {
+    return write_ring(data);
+  }
   size_t write_size = min(remaining_capacity(), data.length());
-  if (write_off_ + write_size < capacity_) {
-    for (size_t cur_write_size = 0; cur_write_size < write_size; ++cur_write_size) {
-      buffer_[write_off_++] = data[cur_write_size];
-    }
-  } else {
-    size_t cur_write_size = 0;
-    for (; write_off_ < capacity_; ++write_off_) {
-      buffer_[write_off_] = data[cur_write_size++];
-    }
-    write_off_ = 0;
-    for (; cur_write_size < write_size; ++cur_write_size) {
-      buffer_[write_off_++] = data[cur_write_size];
-    }
+  return write_size == 0 ? 0 : write_chunk(Buffer(data.substr(0, write_size)));
+}
+
+size_t ByteStream::write(string &&data) {
+  if (storage_ != Storage::Chunked) {
+    return write_ring(data);
+  }
+  data.resize(min(remaining_capacity(), data.length()));
+  // Don't let a short string pin a much larger allocation (e.g. from FileDescriptor::read).
+  if (data.capacity() > 2 * data.size()) {
+    data.shrink_to_fit();
+  }
+  return data.empty() ? 0 : write_chunk(Buffer(move(data)));
+}
+
+size_t ByteStream::write(Buffer data) {
+  if (storage_ != Storage::Chunked) {
+    return write_ring(data.str());
   }
+  return write_chunk(move(data));
+}
+
+size_t ByteStream::write_ring(string_view data) {
+  size_t write_size = min(remaining_capacity(), data.length());
+  if (write_size == 0) {
+    return 0;
+  }
+  size_t done_size = 0;
+  for (const iovec &region : writable_regions(write_size)) {
+    copy(data.begin() + done_size, data.begin() + done_size + region.iov_len, static_cast<char *>(region.iov_base));
+    done_size += region.iov_len;
+  }
+  commit_ring(write_size);
+  return write_size;
+}
+
+size_t ByteStream::write_chunk(Buffer chunk) {
+  size_t write_size = min(remaining_capacity(), chunk.size());
+  if (write_size == 0) {
+    return 0;
+  }
+  chunk.remove_suffix(chunk.size() - write_size);
+  chunks_.append(chunk);
   buffer_size_ += write_size;
   total_nwrite_ += write_size;
+  notify_watermarks(buffer_size_ - write_size);
   return write_size;
 }
 
+pair<string_view, string_view> ByteStream::readable_regions(const size_t len) const {
+  size_t peek_size = min(buffer_size(), len);
+  if (mirror_ || read_off_ + peek_size <= ring_size()) {
+    return {string_view(ring_data() + read_off_, peek_size), {}};
+  }
+  size_t first_size = ring_size() - read_off_;
+  return {string_view(ring_data() + read_off_, first_size), string_view(ring_data(), peek_size - first_size)};
+}
+
+vector<iovec> ByteStream::writable_regions(const size_t len) {
+  size_t free_size = min(remaining_capacity(), len);
+  reserve_ring(free_size);
+  size_t first_size = mirror_ ? free_size : min(free_size, ring_size() - write_off_);
+  vector<iovec> regions{{ring_data() + write_off_, first_size}};
+  if (free_size > first_size) {
+    regions.push_back({ring_data(), free_size - first_size});
+  }
+  return regions;
+}
+
+//! \details The ring is grown to the next power of two (and at least a page), so
+//! a stream filled by small writes is re-laid out O(log(capacity)) times, and
+//! never beyond the power of two covering the stream's capacity.
+//! Readable and staged bytes move to the front of the new ring, which is left uninitialized.
+void ByteStream::reserve_ring(const size_t len) {
+  size_t needed_size = buffer_size_ + max(len, staged_size_);
+  if (needed_size <= ring_size()) {
+    return;
+  }
+  size_t new_size = min(max(round_up_pow2(needed_size), PAGE_SIZE), round_up_pow2(capacity_));
+  unique_ptr<char[]> ring(new char[new_size]);
+  size_t used_size = buffer_size_ + staged_size_;
+  if (used_size > 0) {
+    size_t first_size = min(used_size, buffer_alloc_size_ - read_off_);
+    char *next = copy_n(buffer_.get() + read_off_, first_size, ring.get());
+    copy_n(buffer_.get(), used_size - first_size, next);
+  }
+  buffer_ = move(ring);
+  buffer_alloc_size_ = new_size;
+  read_off_ = 0;
+  write_off_ = buffer_size_ & ring_mask();
+}
+
+//! \details A Storage::Ring ring grows on demand anyway, so only a MirroredBuffer, which is
+//! mapped up front, is replaced; readable and staged bytes move to its front.
+void ByteStream::grow_capacity(const size_t capacity) {
+  if (capacity <= capacity_) {
+    return;
+  }
+  capacity_ = capacity;
+  if (!mirror_ || round_up_pow2(capacity_) <= mirror_->size()) {
+    return;
+  }
+  MirroredBuffer ring(round_up_pow2(capacity_), capacity_ >= HUGE_PAGE_MIN_CAPACITY);
+  copy_n(ring_data() + read_off_, buffer_size_ + staged_size_, ring.data());
+  mirror_ = move(ring);
+  read_off_ = 0;
+  write_off_ = buffer_size_;
+}
+
+void ByteStream::shrink_to_fit() {
+  if (buffer_size_ == 0 && staged_size_ == 0 && buffer_) {
+    buffer_.reset();
+    buffer_alloc_size_ = 0;
+    read_off_ = write_off_ = 0;
+  }
+}
+
+void ByteStream::commit_ring(const size_t len) {
+  if (len == 0) {
+    return;
+  }
+  write_off_ = (write_off_ + len) & ring_mask();
+  buffer_size_ += len;
+  total_nwrite_ += len;
+  staged_size_ -= min(staged_size_, len);
+  notify_watermarks(buffer_size_ - len);
+}
+
+void ByteStream::set_low_watermark(const size_t bytes, WatermarkCallback callback) {
+  low_watermark_ = bytes;
+  on_low_watermark_ = move(callback);
+}
+
+void ByteStream::set_high_watermark(const size_t bytes, WatermarkCallback callback) {
+  high_watermark_ = bytes;
+  on_high_watermark_ = move(callback);
+}
+
+void ByteStream::notify_watermarks(const size_t size_before) {
+  if (on_low_watermark_ && size_before > low_watermark_ && buffer_size_ <= low_watermark_) {
+    on_low_watermark_();
+  }
+  if (on_high_watermark_ && size_before < high_watermark_ && buffer_size_ >= high_watermark_) {
+    on_high_watermark_();
+  }
+}
+
+//! \param[in] len is the maximum number of bytes the caller will produce
+//! \returns the writable regions: free space in the ring, or a pending string with Storage::Chunked
+vector<iovec> ByteStream::prepare(const size_t len) {
+  size_t prepare_size = min(remaining_capacity(), len);
+  if (storage_ == Storage::Chunked) {
+    // cap the pending string, so that a short read doesn't allocate and zero the whole free capacity
+    prepared_size_ = min(prepare_size, FileDescriptor::BUFFER_SIZE);
+    pending_.resize(prepared_size_);
+    return {{pending_.data(), prepared_size_}};
+  }
+  prepared_size_ = prepare_size;
+  return writable_regions(prepare_size);
+}
+
+//! \param[in] len is the number of bytes, at the start of the prepared or staged regions, to publish
+//! \returns the number of bytes accepted into the stream
+size_t ByteStream::commit(const size_t len) {
+  size_t commit_size = min(max(prepared_size_, staged_size_), len);
+  prepared_size_ = 0;
+  if (storage_ == Storage::Chunked) {
+    pending_.resize(commit_size);
+    return write(exchange(pending_, string()));
+  }
+  commit_ring(commit_size);
+  return commit_size;
+}
+
+//! \param[in] offset is how far past the end of the stream the first byte of `data` goes
+//! \param[in] data is the bytes to place
+//! \returns the number of bytes placed, or 0 with Storage::Chunked
+size_t ByteStream::write_at(const size_t offset, const string_view data) {
+  if (storage_ == Storage::Chunked || offset >= remaining_capacity()) {
+    return 0;
+  }
+  size_t write_size = min(remaining_capacity() - offset, data.size());
+  size_t skipped_size = 0;
+  size_t done_size = 0;
+  for (const iovec &region : writable_regions(offset + write_size)) {
+    size_t skip = min(region.iov_len, offset - skipped_size);
+    skipped_size += skip;
+    size_t len = region.iov_len - skip;
+    copy_n(data.begin() + done_size, len, static_cast<char *>(region.iov_base) + skip);
+    done_size += len;
+  }
+  staged_size_ = max(staged_size_, offset + write_size);
+  return write_size;
+}
+
+void ByteStream::unstage(const size_t extent) {
+  staged_size_ = min(staged_size_, extent);
+}
+
+//! \param[in] fd is the FileDescriptor to read from
+//! \param[in] limit is the maximum number of bytes to read
+//! \returns the number of bytes read into the stream
+size_t ByteStream::read_from(FileDescriptor &fd, const size_t limit) {
+  return commit(fd.read(prepare(limit)));
+}
+
 //! \param[in] len bytes will be copied from the output side of the buffer
 string ByteStream::peek_output(const size_t len) const {
-  size_t peek_size = min(buffer_size(), len);
-  string content;
-  if (read_off_ + peek_size <= capacity_) {
-    content += string(buffer_.begin() + read_off_, buffer_.begin() + read_off_ + peek_size);
-  } else {
-    content += string(buffer_.begin() + read_off_, buffer_.end());
-    size_t already_read_size = capacity_ - read_off_;
-    content += string(buffer_.begin(), buffer_.begin() + (peek_size - already_read_size));
+  if (storage_ == Storage::Chunked) {
+    size_t remaining_size = min(buffer_size(), len);
+    string content;
+    content.reserve(remaining_size);
+    for (auto it = chunks_.buffers().begin(); remaining_size > 0; ++it) {
+      string_view view = it->str().substr(0, remaining_size);
+      content.append(view);
+      remaining_size -= view.size();
+    }
+    return content;
   }
+  auto [first, second] = readable_regions(len);
+  string content;
+  content.reserve(first.size() + second.size());
+  content.append(first).append(second);
   return content;
 }
 
+//! \param[in] len bytes will be viewed from the output side of the buffer
+BufferViewList ByteStream::peek_output_view(const size_t len) const {
+  if (storage_ == Storage::Chunked) {
+    size_t remaining_size = min(buffer_size(), len);
+    BufferViewList views;
+    for (auto it = chunks_.buffers().begin(); remaining_size > 0; ++it) {
+      string_view view = it->str().substr(0, remaining_size);
+      views.append(view);
+      remaining_size -= view.size();
+    }
+    return views;
+  }
+  auto [first, second] = readable_regions(len);
+  BufferViewList views{first};
+  if (!second.empty()) {
+    views.append(second);
+  }
+  return views;
+}
+
 //! \param[in] len bytes will be removed from the output side of the buffer
 void ByteStream::pop_output(const size_t len) {
   size_t pop_size = min(buffer_size(), len);
-  read_off_ = (read_off_ + pop_size) % capacity_;
+  if (storage_ == Storage::Chunked) {
+    chunks_.remove_prefix(pop_size);
+  } else {
+    read_off_ = (read_off_ + pop_size) & ring_mask();
+  }
   buffer_size_ -= pop_size;
   total_nread_ += pop_size;
+  notify_watermarks(buffer_size_ + pop_size);
+}
+
+vector<string_view> ByteStream::readable_spans() const {
+  vector<string_view> spans;
+  if (storage_ == Storage::Chunked) {
+    for (const Buffer &chunk : chunks_.buffers()) {
+      spans.push_back(chunk.str());
+    }
+  } else if (buffer_size_ > 0) {
+    auto [first, second] = readable_regions(buffer_size_);
+    spans.push_back(first);
+    if (!second.empty()) {
+      spans.push_back(second);
+    }
+  }
+  return spans;
+}
+
+//! \param[in] c is the byte to look for
+//! \param[in] pos is the offset from the output side to start at
+//! \details Each region is scanned with memchr, which is vectorized by the C library.
+size_t ByteStream::find(const char c, const size_t pos) const {
+  size_t span_start = 0;
+  for (string_view span : readable_spans()) {
+    if (pos < span_start + span.size()) {
+      size_t skip = pos > span_start ? pos - span_start : 0;
+      const void *match = memchr(span.data() + skip, c, span.size() - skip);
+      if (match) {
+        return span_start + (static_cast<const char *>(match) - span.data());
+      }
+    }
+    span_start += span.size();
+  }
+  return npos;
+}
+
+//! \param[in] str is the bytes to look for
+//! \param[in] pos is the offset from the output side to start at
+//! \details Matches inside one region are found with string_view::find. Only the
+//! last `str.size() - 1` starting positions of each region are compared byte by byte,
+//! against the regions that follow.
+size_t ByteStream::find(const string_view str, const size_t pos) const {
+  if (str.empty()) {
+    return pos <= buffer_size_ ? pos : npos;
+  }
+  const vector<string_view> spans = readable_spans();
+  size_t span_start = 0;
+  for (size_t i = 0; i < spans.size(); span_start += spans[i].size(), ++i) {
+    const string_view span = spans[i];
+    if (pos >= span_start + span.size()) {
+      continue;
+    }
+    size_t skip = pos > span_start ? pos - span_start : 0;
+    size_t match = span.find(str, skip);
+    if (match != string_view::npos) {
+      return span_start + match;
+    }
+
+    // candidates that start in this region and end in a later one
+    size_t first_candidate = max(skip, span.size() > str.size() - 1 ? span.size() - (str.size() - 1) : 0);
+    for (size_t candidate = first_candidate; candidate < span.size(); ++candidate) {
+      size_t matched = 0;
+      string_view rest = span.substr(candidate);
+      for (size_t j = i;;) {
+        size_t len = min(rest.size(), str.size() - matched);
+        if (rest.compare(0, len, str.substr(matched, len)) != 0) {
+          break;
+        }
+        matched += len;
+        if (matched == str.size() || ++j == spans.size()) {
+          break;
+        }
+        rest = spans[j];
+      }
+      if (matched == str.size()) {
+        return span_start + candidate;
+      }
+    }
+  }
+  return npos;
+}
+
+//! \param[in] delim is the delimiter that ends the bytes to read
+//! \returns the bytes up to and including `delim`, or an empty Buffer
+Buffer ByteStream::read_until(const string_view delim) {
+  size_t match = find(delim);
+  if (match == npos) {
+    return Buffer();
+  }
+  return read_buffer(match + delim.size());
+}
+
+//! \param[in] fd is the FileDescriptor to write to
+//! \param[in] limit is the maximum number of bytes to write
+//! \returns the number of bytes written and popped
+size_t ByteStream::write_to(FileDescriptor &fd, const size_t limit) {
+  size_t nwrite = fd.write(peek_output_view(limit), false);
+  pop_output(nwrite);
+  return nwrite;
 }
 
 //! Read (i.e., copy and then pop) the next "len" bytes of the stream
@@ -69,3 +407,18 @@ string ByteStream::read(const size_t len) {
   pop_output(len);
   return content;
 }
+
+//! \param[in] len bytes will be popped and returned
+//! \returns a Buffer owning a single copy of the bytes, or sharing the front chunk
+Buffer ByteStream::read_buffer(const size_t len) {
+  size_t read_size = min(buffer_size(), len);
+  if (storage_ == Storage::Chunked && read_size > 0 && chunks_.buffers().front().size() >= read_size) {
+    Buffer content = chunks_.buffers().front();
+    content.remove_suffix(content.size() - read_size);
+    pop_output(read_size);
+    return content;
+  }
+  string content = peek_output(read_size);
+  pop_output(read_size);
+  return Buffer(move(content));
+}
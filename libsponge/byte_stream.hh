@@ -1,7 +1,18 @@
 #ifndef SPONGE_LIBSPONGE_BYTE_STREAM_HH
 #define SPONGE_LIBSPONGE_BYTE_STREAM_HH
 
+#include "buffer.hh"
+#include "file_descriptor.hh"
+#include "mirrored_buffer.hh"
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <sys/uio.h>
+#include <utility>
 #include <vector>
 
 //! \brief An in-order byte stream.
@@ -10,6 +21,20 @@
 //! side.  The byte stream is finite: the writer can end the input,
 //! and then no more bytes can be written.
 class ByteStream {
+  public:
+    //! How the bytes between the writer and the reader are stored
+    enum class Storage {
+        Ring,     //!< Writes are copied into a ring buffer that grows on demand and is freed by shrink_to_fit()
+        Chunked,  //!< Writes are kept as a queue of ref-counted Buffers, taking ownership where possible
+        Mirrored,  //!< Writes are copied into a MirroredBuffer, so readable and free space are never split
+    };
+
+    //! Returned by find() when there is no match
+    static constexpr size_t npos = std::string_view::npos;
+
+    //! Called when buffer_size() crosses a watermark
+    using WatermarkCallback = std::function<void(void)>;
+
   private:
     // Your code here -- add private members as necessary.
 
@@ -17,7 +42,20 @@ class ByteStream {
     // all, but if any of your tests are taking longer than a second,
     // that's a sign that you probably want to keep exploring
     // different approaches.
-    std::vector<char> buffer_;
+    // Granularity in which the ring grows.
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    // Smallest capacity for which Storage::Mirrored asks for huge pages.
+    static constexpr size_t HUGE_PAGE_MIN_CAPACITY = MirroredBuffer::HUGE_PAGE_SIZE / 2;
+
+    Storage storage_;
+    std::unique_ptr<char[]> buffer_;  // ring storage (Storage::Ring), grown on demand up to round_up_pow2(capacity_)
+    size_t buffer_alloc_size_;  // bytes allocated for buffer_
+    BufferList chunks_;  // chunk storage (Storage::Chunked)
+    std::optional<MirroredBuffer> mirror_;  // double-mapped ring storage (Storage::Mirrored), mapped up front
+    std::string pending_;  // space handed out by prepare() in Storage::Chunked
+    size_t prepared_size_;  // bytes handed out by the last prepare()
+    size_t staged_size_;  // extent of the bytes placed by write_at(), past the end of the ring's readable bytes
     size_t capacity_;
     size_t read_off_;  // byte index of next read
     size_t write_off_;  // byte index of next write
@@ -26,10 +64,45 @@ class ByteStream {
     size_t total_nwrite_;
     bool input_ended_;
     bool error_;  //!< Flag indicating that the stream suffered an error.
+    size_t low_watermark_;
+    size_t high_watermark_;
+    WatermarkCallback on_low_watermark_;
+    WatermarkCallback on_high_watermark_;
+
+    // All readable bytes, in order, as the (possibly split) regions that hold them.
+    std::vector<std::string_view> readable_spans() const;
+
+    // Fire the watermark callbacks whose thresholds buffer_size_ just crossed, coming from `size_before`.
+    void notify_watermarks(const size_t size_before);
+
+    // Copy as much of `data` as fits into the ring, returns the number of bytes written.
+    size_t write_ring(std::string_view data);
+
+    // Queue as much of `chunk` as fits without copying, returns the number of bytes written.
+    size_t write_chunk(Buffer chunk);
+
+    // The ring in use: mirror_ for Storage::Mirrored, buffer_ otherwise.
+    char *ring_data() { return mirror_ ? mirror_->data() : buffer_.get(); }
+    const char *ring_data() const { return mirror_ ? mirror_->data() : buffer_.get(); }
+    size_t ring_size() const { return mirror_ ? mirror_->size() : buffer_alloc_size_; }
+    // The ring size is always a power of two, so offsets wrap with a mask rather than a division.
+    size_t ring_mask() const { return ring_size() - 1; }
+
+    // At most `len` readable bytes, as the regions before and after the end of the ring.
+    std::pair<std::string_view, std::string_view> readable_regions(const size_t len) const;
+
+    // Grow the ring (if needed) so that `len` more bytes fit without wrapping onto unread or staged ones.
+    void reserve_ring(const size_t len);
+
+    // Free space for at most `len` bytes, as the regions before and after the end of the ring.
+    std::vector<iovec> writable_regions(const size_t len);
+
+    // Account for `len` bytes that have been placed at the start of the writable regions.
+    void commit_ring(const size_t len);
 
   public:
     //! Construct a stream with room for `capacity` bytes.
-    ByteStream(const size_t capacity);
+    ByteStream(const size_t capacity, const Storage storage = Storage::Ring);
 
     //! \name "Input" interface for the writer
     //!@{
@@ -39,9 +112,55 @@ class ByteStream {
     //! \returns the number of bytes accepted into the stream
     size_t write(const std::string &data);
 
+    //! Write a string of bytes into the stream, taking ownership of it
+    //! if the stream uses Storage::Chunked.
+    //! \returns the number of bytes accepted into the stream
+    size_t write(std::string &&data);
+
+    //! Write a Buffer into the stream, sharing it (rather than copying it)
+    //! if the stream uses Storage::Chunked.
+    //! \returns the number of bytes accepted into the stream
+    size_t write(Buffer data);
+
+    //! Read up to `limit` bytes from `fd` directly into the stream's free space
+    //! (no more than remaining_capacity()), with a single [readv(2)](\ref man2::readv)
+    //! \returns the number of bytes read
+    size_t read_from(FileDescriptor &fd, const size_t limit = std::numeric_limits<size_t>::max());
+
+    //! Get free space for up to `len` bytes (no more than remaining_capacity(), and with
+    //! Storage::Chunked no more than FileDescriptor::BUFFER_SIZE) to be filled in place
+    //! \returns the writable regions, in stream order
+    //! \note The regions are invalidated by any other write to or pop from the stream, including commit()
+    std::vector<iovec> prepare(const size_t len);
+
+    //! Publish the first `len` bytes of the regions returned by the last prepare()
+    //! or placed by write_at() (no more than were prepared or placed), exactly as
+    //! if they had been passed to write()
+    //! \returns the number of bytes accepted into the stream
+    size_t commit(const size_t len);
+
+    //! Place `data` in the free space, `offset` bytes past the end of the stream, without
+    //! publishing it; a later commit() that reaches it publishes it in place. Bytes placed
+    //! this way survive pops and growth of the ring, and are overwritten by write().
+    //! \note Only Storage::Ring and Storage::Mirrored have free space to place bytes in.
+    //! \returns the number of bytes placed (those that fall within remaining_capacity())
+    size_t write_at(const size_t offset, const std::string_view data);
+
+    //! Forget the bytes placed by write_at() more than `extent` bytes past the end of the stream,
+    //! e.g. when they are dropped rather than published, so that shrink_to_fit() can free the ring
+    void unstage(const size_t extent);
+
+    //! Free the ring of a Storage::Ring stream if nothing is buffered or staged, e.g. for an idle
+    //! connection or under memory pressure; it is otherwise kept, to be reused by later writes
+    void shrink_to_fit();
+
     //! \returns the number of additional bytes that the stream has space for
     size_t remaining_capacity() const { return capacity_ - buffer_size_; }
 
+    //! Raise the capacity to `capacity` bytes (a smaller value leaves it unchanged), e.g. to auto-tune a buffer
+    //! \note With Storage::Mirrored, the ring is remapped if it no longer covers the capacity.
+    void grow_capacity(const size_t capacity);
+
     //! Signal that the byte stream has reached its ending
     void end_input() { input_ended_ = true; }
 
@@ -56,6 +175,11 @@ class ByteStream {
     //! \returns a string
     std::string peek_output(const size_t len) const;
 
+    //! Peek at next "len" bytes of the stream without copying them
+    //! \returns views of (at most two) regions of the buffer, or a single view with Storage::Mirrored
+    //! \note The views are invalidated by the next write to or pop from the stream
+    BufferViewList peek_output_view(const size_t len) const;
+
     //! Remove bytes from the buffer
     void pop_output(const size_t len);
 
@@ -63,6 +187,30 @@ class ByteStream {
     //! \returns a string
     std::string read(const size_t len);
 
+    //! Read (i.e., copy and then pop) the next "len" bytes of the stream
+    //! \returns a ref-counted Buffer, e.g. to become a segment payload
+    //! \note With Storage::Chunked, bytes from a single written chunk are shared rather than copied.
+    Buffer read_buffer(const size_t len);
+
+    //! Find the first `c` at or after offset `pos` of the readable bytes, searching
+    //! the stored regions in place
+    //! \returns the offset of the match from the output side, or ByteStream::npos
+    size_t find(const char c, const size_t pos = 0) const;
+
+    //! Find the first occurrence of `str` at or after offset `pos` of the readable bytes,
+    //! including matches that span a ring wrap or a chunk boundary
+    //! \returns the offset of the match from the output side, or ByteStream::npos
+    size_t find(const std::string_view str, const size_t pos = 0) const;
+
+    //! Read the bytes up to and including the first `delim`, e.g. to frame a line
+    //! \returns the bytes (as by read_buffer()), or an empty Buffer, reading nothing, if `delim` isn't buffered
+    Buffer read_until(const std::string_view delim);
+
+    //! Write up to `limit` bytes from the stream directly to `fd` with a single
+    //! [writev(2)](\ref man2::writev), and pop the bytes that were written
+    //! \returns the number of bytes written
+    size_t write_to(FileDescriptor &fd, const size_t limit = std::numeric_limits<size_t>::max());
+
     //! \returns `true` if the stream input has ended
     bool input_ended() const { return input_ended_;  }
 
@@ -79,9 +227,33 @@ class ByteStream {
     bool eof() const { return input_ended() && buffer_empty(); }
     //!@}
 
+    //! \name Watermark notifications
+    //! Callbacks that fire only when buffer_size() crosses a threshold, similar to
+    //! `SO_SNDLOWAT`/`SO_RCVLOWAT`, so a writer or reader can wait for enough room or
+    //! enough data instead of re-checking the stream. Setting a callback replaces the
+    //! previous one; an empty callback removes it.
+    //! \note The callbacks move along with the stream.
+    //!@{
+
+    //! Call `callback` whenever buffer_size() drops from above `bytes` to `bytes` or below
+    void set_low_watermark(const size_t bytes, WatermarkCallback callback);
+
+    //! Call `callback` whenever buffer_size() rises from below `bytes` to `bytes` or above
+    void set_high_watermark(const size_t bytes, WatermarkCallback callback);
+    //!@}
+
     //! \name General accounting
     //!@{
 
+    //! How this stream stores its bytes
+    Storage storage() const { return storage_; }
+
+    //! The most bytes the stream can hold
+    size_t capacity() const { return capacity_; }
+
+    //! Bytes of ring storage currently allocated (0 with Storage::Chunked, and before a Storage::Ring is written)
+    size_t allocated_ring_size() const { return ring_size(); }
+
     //! Total number of bytes written
     size_t bytes_written() const { return total_nwrite_; }
 
@@ -8,74 +8,274 @@
 
 using namespace std;
 
-StreamReassembler::StreamReassembler(const size_t capacity) :
-  bitmap_(capacity, false),
-  buffer_(capacity),
+StreamReassembler::StreamReassembler(const size_t capacity,
+                                     const ByteStream::Storage storage,
+                                     const size_t memory_budget) :
+  segments_(),
+  resident_bytes_(0),
+  memory_budget_(memory_budget),
   unassembled_bytes_(0),
   first_unassembled_index_(0),
   eof_index_(0),
   has_met_eof_(false),
-  output_(capacity),
+  output_(capacity, storage),
   capacity_(capacity) {}
 
-//! \details This function accepts a substring (aka a segment) of bytes,
-//! possibly out-of-order, from the logical stream, and assembles any newly
-//! contiguous substrings and writes them into the output stream in order.
-void StreamReassembler::push_substring(const string &data, const size_t index, const bool eof) {
-  // Note:
-  // 1. StreamReassmbler could be resued, which means after all current segments have been placed
-  // into ByteStream, another segments will come; thus bitmap must be clear after placement.
-  // 2. data received could have overlapping.
+//! \details Segments never overlap, so only the gaps between them are recorded.
+//! The new segments' data is left for the caller to fill in.
+vector<map<uint64_t, StreamReassembler::Segment>::iterator> StreamReassembler::claim_gaps(uint64_t start,
+                                                                                       const uint64_t end) {
+  vector<map<uint64_t, Segment>::iterator> gaps;
 
-  // Segment's effective substring index is [start_index, end_index) in total order.
-  size_t start_index = max(first_unassembled_index_, index);
-  size_t end_index = min(first_unassembled_index_ + output_.remaining_capacity(), index + data.length());
-
-  // Set bitmap and buffer.
-  for (size_t idx = start_index; idx < end_index; ++idx) {
-    size_t buffer_index = idx % capacity_;
-    buffer_[buffer_index] = data[idx - index];
-    if (!bitmap_[buffer_index]) {
-      ++unassembled_bytes_;
-      bitmap_[buffer_index] = true;
+  // skip what the segment before `start` already covers
+  auto it = segments_.upper_bound(start);
+  if (it != segments_.begin()) {
+    start = max(start, prev(it)->second.end);
+  }
+
+  while (start < end) {
+    // `it` is the first segment starting after `start`
+    uint64_t gap_end = it == segments_.end() ? end : min(end, it->first);
+    if (gap_end > start) {
+      gaps.push_back(segments_.emplace_hint(it, start, Segment{gap_end, {}, 0}));
+      unassembled_bytes_ += gap_end - start;
+    }
+    if (it == segments_.end()) {
+      break;
+    }
+    start = it->second.end;
+    ++it;
+  }
+  return gaps;
+}
+
+//! \details The other storages copy the bytes into the stream anyway, so only Storage::Chunked needs this.
+size_t StreamReassembler::write_output(Buffer data) {
+  if (output_.storage() == ByteStream::Storage::Chunked && data.footprint() > COMPACT_RATIO * data.size()) {
+    data = Buffer(data.copy());
+  }
+  return output_.write(move(data));
+}
+
+void StreamReassembler::submit_ranges() {
+  while (!segments_.empty() && segments_.begin()->first == first_unassembled_index_) {
+    Segment segment = move(segments_.begin()->second);
+    segments_.erase(segments_.begin());
+
+    size_t submit_length = segment.end - first_unassembled_index_;
+    resident_bytes_ -= segment.charge;
+    [[maybe_unused]] size_t nwrite = 0;
+    if (output_.storage() == ByteStream::Storage::Chunked) {
+      nwrite = write_output(move(segment.data));
+    } else {
+      nwrite = output_.commit(submit_length);
     }
+    assert(nwrite == submit_length);  // waiting bytes always fit in the output's free space
+    first_unassembled_index_ += submit_length;
+    unassembled_bytes_ -= submit_length;
+  }
+}
+
+void StreamReassembler::assemble(Buffer data, const uint64_t index) {
+  // Segment's effective substring index is [start_index, end_index) in total order.
+  uint64_t start_index = max<uint64_t>(first_unassembled_index_, index);
+  uint64_t end_index = min<uint64_t>(first_unassembled_index_ + output_.remaining_capacity(), index + data.size());
+  if (start_index >= end_index) {
+    return;
+  }
+  data.remove_prefix(start_index - index);
+  data.remove_suffix(data.size() - (end_index - start_index));
+
+  // Fast path: in-order data with nothing waiting goes straight to the output.
+  if (start_index == first_unassembled_index_ && segments_.empty()) {
+    [[maybe_unused]] size_t nwrite = write_output(move(data));
+    assert(nwrite == end_index - start_index);
+    first_unassembled_index_ = end_index;
+    return;
+  }
+
+  auto gaps = claim_gaps(start_index, end_index);
+  size_t kept_size = 0;
+  for (auto gap : gaps) {
+    kept_size += gap->second.end - gap->first;
   }
 
-  // Get the end index of possible submission.
-  size_t submit_end_index = first_unassembled_index_;
-  for (; bitmap_[submit_end_index % capacity_] &&
-        submit_end_index < first_unassembled_index_ + capacity_;
-        ++submit_end_index);
-
-  // Submit all possible characters.
-  if (submit_end_index > first_unassembled_index_) {  // there's character to submit
-    // Note: considering buffer index is circular, cannot assign string value as:
-    // size_t start_buffer_index = first_unassembled_index_ % capacity_;
-    // size_t end_buffer_index = end_buffer_index % capacity_;
-    // string submit_data(buffer_.begin() + first_unassembled_index_, buffer_.begin() + submit_end_index);
-    // size_t submit_length = submit_end_index - first_unassembled_index_;
-
-    size_t submit_length = submit_end_index - first_unassembled_index_;
-    string submit_data(submit_length, 0);
-    for (size_t idx = first_unassembled_index_; idx < submit_end_index; ++idx) {
-      submit_data[idx - first_unassembled_index_] = buffer_[idx % capacity_];
+  // Don't let a few kept bytes pin a mostly-wasted allocation (e.g. a whole datagram or TUN read).
+  const size_t footprint = data.footprint();
+  const bool compact = footprint > COMPACT_RATIO * kept_size;
+  for (auto gap : gaps) {
+    Buffer segment = data;
+    segment.remove_prefix(gap->first - start_index);
+    segment.remove_suffix(end_index - gap->second.end);
+    if (compact) {
+      segment = Buffer(segment.copy());
+      gap->second.charge = segment.size();
+    } else {
+      gap->second.charge = segment.size() * footprint / kept_size;  // gaps split the allocation they share
     }
+    resident_bytes_ += gap->second.charge;
+    gap->second.data = move(segment);
+  }
+}
+
+void StreamReassembler::grow_capacity(const size_t capacity) {
+  capacity_ = max(capacity_, capacity);
+  output_.grow_capacity(capacity_);
+}
+
+void StreamReassembler::discard_unassembled() {
+  segments_.clear();
+  unassembled_bytes_ = 0;
+  resident_bytes_ = 0;
+  unstage_dropped();
+}
+
+//! \details With ByteStream::Storage::Ring, this lets the output free its ring once it drains:
+//! right away if it already has, otherwise at the next ByteStream::shrink_to_fit().
+void StreamReassembler::unstage_dropped() {
+  const uint64_t end = segments_.empty() ? first_unassembled_index_ : prev(segments_.end())->second.end;
+  output_.unstage(end - first_unassembled_index_);
+  output_.shrink_to_fit();
+}
+
+//! \details Like Linux's tcp_collapse and tcp_prune_ofo_queue: the bytes that are
+//! dropped have not been acknowledged, so the sender will retransmit them.
+void StreamReassembler::enforce_memory_budget() {
+  if (resident_bytes_ <= memory_budget_) {
+    return;
+  }
 
-    size_t nwrite = output_.write(submit_data);
-    assert(nwrite == submit_length);
-    for (size_t idx = first_unassembled_index_; idx < first_unassembled_index_ + nwrite; ++idx) {
-      bitmap_[idx % capacity_] = false;  // clear bitmap for next round's reuse
+  for (auto &entry : segments_) {
+    Segment &segment = entry.second;
+    if (output_.storage() == ByteStream::Storage::Chunked && segment.charge > segment.data.size()) {
+      resident_bytes_ -= segment.charge;
+      segment.data = Buffer(segment.data.copy());
+      segment.charge = segment.data.size();
+      resident_bytes_ += segment.charge;
     }
-    first_unassembled_index_ = submit_end_index;
-    unassembled_bytes_ -= nwrite;
   }
 
-  // Handle EOF.
+  while (resident_bytes_ > memory_budget_ && !segments_.empty()) {
+    auto last = prev(segments_.end());
+    unassembled_bytes_ -= last->second.end - last->first;
+    resident_bytes_ -= last->second.charge;
+    segments_.erase(last);
+  }
+  unstage_dropped();
+}
+
+void StreamReassembler::assemble_in_place(string_view data, const uint64_t index) {
+  // Segment's effective substring index is [start_index, end_index) in total order.
+  uint64_t start_index = max<uint64_t>(first_unassembled_index_, index);
+  uint64_t end_index = min<uint64_t>(first_unassembled_index_ + output_.remaining_capacity(), index + data.size());
+  if (start_index >= end_index) {
+    return;
+  }
+  data = data.substr(start_index - index, end_index - start_index);
+
+  // Fast path: in-order data with nothing waiting goes straight to the output.
+  if (start_index == first_unassembled_index_ && segments_.empty()) {
+    output_.write_at(0, data);
+    [[maybe_unused]] size_t nwrite = output_.commit(data.size());
+    assert(nwrite == data.size());
+    first_unassembled_index_ = end_index;
+    return;
+  }
+
+  for (auto gap : claim_gaps(start_index, end_index)) {
+    size_t size = gap->second.end - gap->first;
+    output_.write_at(gap->first - first_unassembled_index_, data.substr(gap->first - start_index, size));
+    gap->second.charge = size;  // the bytes occupy that much of the output's ring
+    resident_bytes_ += size;
+  }
+}
+
+void StreamReassembler::check_eof(const uint64_t end_index, const bool eof) {
   if (eof) {
-    eof_index_ = index + data.length();
+    eof_index_ = end_index;
     has_met_eof_ = true;
   }
   if (has_met_eof_ && output_.bytes_written() == eof_index_) {  // all bytes have been placed into ByteStream
       output_.end_input();
   }
 }
+
+//! \details This function accepts a substring (aka a segment) of bytes,
+//! possibly out-of-order, from the logical stream, and assembles any newly
+//! contiguous substrings and writes them into the output stream in order.
+//! Only the bytes that fall within the window are copied.
+void StreamReassembler::push_substring(const string &data, const size_t index, const bool eof) {
+  // Note:
+  // 1. StreamReassmbler could be resued, which means after all current segments have been placed
+  // into ByteStream, another segments will come.
+  // 2. data received could have overlapping.
+  if (output_.storage() != ByteStream::Storage::Chunked) {
+    assemble_in_place(data, index);
+    submit_ranges();
+    enforce_memory_budget();
+    check_eof(index + data.size(), eof);
+    return;
+  }
+
+  size_t window_end = first_unassembled_index_ + output_.remaining_capacity();
+  size_t start_offset = min(data.size(), first_unassembled_index_ > index ? first_unassembled_index_ - index : 0);
+  size_t end_offset = min(data.size(), window_end > index ? window_end - index : 0);
+  if (start_offset < end_offset) {
+    assemble(Buffer(data.substr(start_offset, end_offset - start_offset)), index + start_offset);
+  }
+  submit_ranges();
+  enforce_memory_budget();
+  check_eof(index + data.size(), eof);
+}
+
+//! \details Like the std::string version, but with ByteStream::Storage::Chunked, waiting and
+//! in-order bytes share `data`.
+void StreamReassembler::push_substring(Buffer data, const uint64_t index, const bool eof) {
+  const uint64_t end_index = index + data.size();
+  if (output_.storage() == ByteStream::Storage::Chunked) {
+    assemble(move(data), index);
+  } else {
+    assemble_in_place(data.str(), index);
+  }
+  submit_ranges();
+  enforce_memory_budget();
+  check_eof(end_index, eof);
+}
+
+//! \details Like the std::string version, but with ByteStream::Storage::Chunked, waiting and
+//! in-order bytes share `data`'s Buffers.
+void StreamReassembler::push_substring(const BufferList &data, const uint64_t index, const bool eof) {
+  uint64_t buffer_index = index;
+  for (const Buffer &buffer : data.buffers()) {
+    if (output_.storage() == ByteStream::Storage::Chunked) {
+      assemble(buffer, buffer_index);
+    } else {
+      assemble_in_place(buffer.str(), buffer_index);
+    }
+    buffer_index += buffer.size();
+  }
+  submit_ranges();
+  enforce_memory_budget();
+  check_eof(buffer_index, eof);
+}
+
+//! \details Each excerpt is stored (or, if in order with nothing waiting, written) as
+//! push_substring() would, then a single pass writes everything that became contiguous.
+void StreamReassembler::push_substrings(const vector<Excerpt> &excerpts) {
+  uint64_t eof_index = 0;
+  bool eof = false;
+  for (const Excerpt &excerpt : excerpts) {
+    if (output_.storage() == ByteStream::Storage::Chunked) {
+      assemble(excerpt.data, excerpt.index);
+    } else {
+      assemble_in_place(excerpt.data.str(), excerpt.index);
+    }
+    if (excerpt.eof) {
+      eof_index = excerpt.index + excerpt.data.size();
+      eof = true;
+    }
+  }
+  submit_ranges();
+  enforce_memory_budget();
+  check_eof(eof_index, eof);
+}
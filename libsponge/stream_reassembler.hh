@@ -4,8 +4,10 @@
 #include "byte_stream.hh"
 
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 //! \brief A class that assembles a series of excerpts from a byte stream (possibly out of order,
@@ -13,8 +15,19 @@
 class StreamReassembler {
   private:
     // Your code here -- add private members as necessary.
-    std::vector<bool> bitmap_;  // whether StreamReassembler has received this byte
-    std::vector<char> buffer_;
+
+    // Bytes waiting to be assembled, as non-overlapping ranges of stream indices keyed by start.
+    struct Segment {
+      uint64_t end;  // one past the last stream index of the range
+      Buffer data;   // the bytes, by reference, with ByteStream::Storage::Chunked; otherwise they wait in
+                     // the output stream's free space, at their final position (see ByteStream::write_at())
+      size_t charge;  // the share of resident_bytes_ that the bytes keep alive
+    };
+    std::map<uint64_t, Segment> segments_;
+    // A kept slice is copied out if its allocation is more than this many times its size.
+    static constexpr size_t COMPACT_RATIO = 2;
+    size_t resident_bytes_;  // memory kept alive by segments_ (see resident_bytes())
+    size_t memory_budget_;   // most resident_bytes_ to keep before compacting, then pruning, segments_
     size_t unassembled_bytes_;
     size_t first_unassembled_index_;
     size_t eof_index_;
@@ -22,11 +35,55 @@ class StreamReassembler {
     ByteStream output_;  //!< The reassembled in-order byte stream
     size_t capacity_;    //!< The maximum number of bytes
 
+    // Write in-order bytes to the output; with ByteStream::Storage::Chunked, which keeps them by reference
+    // until they are read, a slice of a mostly-wasted allocation is copied out first (see COMPACT_RATIO).
+    size_t write_output(Buffer data);
+
+    // Record the parts of [start, end) that are not already waiting, and return them (as segments_ entries).
+    std::vector<std::map<uint64_t, Segment>::iterator> claim_gaps(uint64_t start, const uint64_t end);
+
+    // Write the ranges that are now contiguous with the stream.
+    void submit_ranges();
+
+    // Keep the part of `data` (at stream index `index`) that falls within the window, by reference,
+    // writing it right away only if it is in order and nothing is waiting. For ByteStream::Storage::Chunked.
+    void assemble(Buffer data, const uint64_t index);
+
+    // Place the part of `data` that falls within the window in the output's free space, publishing
+    // it right away only if it is in order and nothing is waiting. For ByteStream::Storage::Ring and Mirrored.
+    void assemble_in_place(std::string_view data, const uint64_t index);
+
+    // Over the memory budget, copy out segments that pin mostly-wasted allocations, then drop the
+    // segments furthest ahead of the stream until back within the budget.
+    void enforce_memory_budget();
+
+    // Shrink the bytes the output holds for segments_ (see ByteStream::write_at()) to those still waiting,
+    // and free the output's ring if that leaves it idle.
+    void unstage_dropped();
+
+    // Record the end of the stream if `eof`, and end the output once every byte has been written.
+    void check_eof(const uint64_t end_index, const bool eof);
+
   public:
+    //! A substring of the stream, for push_substrings()
+    struct Excerpt {
+      Buffer data{};     //!< the substring
+      uint64_t index{};  //!< the index of the first byte in `data`
+      bool eof{};        //!< the last byte of `data` is the last byte in the entire stream
+    };
+
     //! \brief Construct a `StreamReassembler` that will store up to `capacity` bytes.
     //! \note This capacity limits both the bytes that have been reassembled,
     //! and those that have not yet been reassembled.
-    StreamReassembler(const size_t capacity);
+    //! \param storage is how the reassembled stream stores its bytes; with ByteStream::Storage::Chunked,
+    //!                Buffers are kept and appended to it without being copied, otherwise bytes are
+    //!                copied once, straight to their place in the stream
+    //! \param memory_budget bounds the memory that bytes waiting to be assembled keep alive (see
+    //!                      resident_bytes()); bytes beyond it are discarded, furthest from the
+    //!                      stream first, as if never received
+    StreamReassembler(const size_t capacity,
+                      const ByteStream::Storage storage = ByteStream::Storage::Ring,
+                      const size_t memory_budget = std::numeric_limits<size_t>::max());
 
     //! \brief Receive a substring and write any newly contiguous bytes into the stream.
     //!
@@ -38,6 +95,20 @@ class StreamReassembler {
     //! \param eof the last byte of `data` will be the last byte in the entire stream
     void push_substring(const std::string &data, const uint64_t index, const bool eof);
 
+    //! \brief Receive a substring as a ref-counted Buffer, keeping (slices of) it by
+    //! reference instead of copying it
+    void push_substring(Buffer data, const uint64_t index, const bool eof);
+
+    //! \brief Receive a substring as a BufferList, keeping (slices of) its Buffers by reference
+    void push_substring(const BufferList &data, const uint64_t index, const bool eof);
+
+    //! \brief Receive a batch of substrings, e.g. from several datagrams read at once
+    //!
+    //! Equivalent to calling push_substring() on each excerpt in turn, but the newly
+    //! contiguous bytes are written to the stream, and the end of the stream is checked for,
+    //! only once, after the whole batch has been stored.
+    void push_substrings(const std::vector<Excerpt> &excerpts);
+
     //! \name Access the reassembled byte stream
     //!@{
     const ByteStream &stream_out() const { return output_; }
@@ -50,6 +121,16 @@ class StreamReassembler {
     //! should only be counted once for the purpose of this function.
     size_t unassembled_bytes() const { return unassembled_bytes_; }
 
+    //! The memory kept alive by the bytes waiting to be assembled: with ByteStream::Storage::Chunked,
+    //! including unused parts of the allocations they share; otherwise, the part of the output's ring they fill
+    size_t resident_bytes() const { return resident_bytes_; }
+
+    //! Raise the capacity to `capacity` bytes (a smaller value leaves it unchanged)
+    void grow_capacity(const size_t capacity);
+
+    //! Discard every byte waiting to be assembled, as if never received
+    void discard_unassembled();
+
     //! \brief Is the internal state empty (other than the output stream)?
     //! \returns `true` if no substrings are waiting to be assembled
     bool empty() const { return unassembled_bytes_ == 0; }
@@ -84,9 +84,24 @@ size_t TCPConnection::write(const string &data) {
   return nwriten;
 }
 
+size_t TCPConnection::write(string &&data) {
+  size_t nwriten = sender_.stream_in().write(move(data));
+  sender_.fill_window();
+  send_out_segment();
+  return nwriten;
+}
+
+size_t TCPConnection::write_from(FileDescriptor &fd) {
+  size_t nread = sender_.stream_in().read_from(fd);
+  sender_.fill_window();
+  send_out_segment();
+  return nread;
+}
+
 //! \param[in] ms_since_last_tick number of milliseconds since the last call to this method
 void TCPConnection::tick(const size_t ms_since_last_tick) {
   sender_.tick(ms_since_last_tick);
+  receiver_.tick(ms_since_last_tick);
   time_since_last_segment_received_ += ms_since_last_tick;
   if (sender_.consecutive_retransmissions() > TCPConfig::MAX_RETX_ATTEMPTS) {
     send_rst_segment();
@@ -134,7 +149,7 @@ void TCPConnection::dump_receiver_information(TCPSegment *seg) {
   if (ackno_opt.has_value()) {
     seg->header().ack = true;
     seg->header().ackno = ackno_opt.value();
-    seg->header().win = receiver_.window_size();
+    seg->header().win = receiver_.advertise_window(TCPConfig::MAX_WINDOW);
   }
 }
 
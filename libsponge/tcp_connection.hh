@@ -10,8 +10,8 @@
 class TCPConnection {
   private:
     TCPConfig cfg_;
-    TCPReceiver receiver_{cfg_.recv_capacity};
-    TCPSender sender_{cfg_.send_capacity, cfg_.rt_timeout, cfg_.fixed_isn};
+    TCPReceiver receiver_{cfg_};
+    TCPSender sender_{cfg_};
 
     //! outbound queue of segments that the TCPConnection wants sent
     std::queue<TCPSegment> segments_out_{};
@@ -48,6 +48,14 @@ class TCPConnection {
     //! \returns the number of bytes from `data` that were actually written.
     size_t write(const std::string &data);
 
+    //! \brief Write data to the outbound byte stream, handing over the string if the stream can keep it
+    //! \returns the number of bytes from `data` that were actually written.
+    size_t write(std::string &&data);
+
+    //! \brief Read data from `fd` straight into the outbound byte stream, and send it over TCP if possible
+    //! \returns the number of bytes that were read from `fd` (at most remaining_outbound_capacity())
+    size_t write_from(FileDescriptor &fd);
+
     //! \returns the number of `bytes` that can be written right now.
     size_t remaining_outbound_capacity() const { return sender_.stream_in().remaining_capacity(); }
 
@@ -69,6 +77,8 @@ class TCPConnection {
     size_t bytes_in_flight() const { return sender_.bytes_in_flight(); }
     //! \brief number of bytes not yet reassembled
     size_t unassembled_bytes() const { return receiver_.unassembled_bytes(); }
+    //! \brief smoothed round-trip time in milliseconds, or 0 before the first sample
+    size_t smoothed_rtt() const { return sender_.smoothed_rtt(); }
     //! \brief Number of milliseconds since the last segment was received
     size_t time_since_last_segment_received() const { return time_since_last_segment_received_; }
     //!< \brief summarize the state of the sender, receiver, and the connection
@@ -84,6 +94,9 @@ class TCPConnection {
     //! Called periodically when time elapses
     void tick(const size_t ms_since_last_tick);
 
+    //! \brief Milliseconds until tick() will send segments that pacing holds back, if it holds any
+    std::optional<size_t> time_until_send() const { return sender_.time_until_send(); }
+
     //! \brief TCPSegments that the TCPConnection has enqueued for transmission.
     //! \note The owner or operating system will dequeue these and
     //! put each one into the payload of a lower-layer datagram (usually Internet datagrams (IP),
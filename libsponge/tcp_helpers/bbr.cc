@@ -0,0 +1,180 @@
+#include "bbr.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+void BBR::on_ack(const Ack &ack) {
+    update_round(ack);
+    update_bandwidth(ack);
+    check_full_pipe(ack);
+    if (_mode == Mode::Startup && _filled_pipe) {
+        _mode = Mode::Drain;
+        _pacing_gain = 1 / HIGH_GAIN;
+        _cwnd_gain = HIGH_GAIN;
+    }
+    if (_mode == Mode::Drain && ack.bytes_in_flight <= target_inflight(1)) {
+        enter_probe_bw(ack.now_ms);
+    }
+    update_gain_cycle(ack);
+    update_min_rtt(ack);
+    update_pacing_rate(ack);
+    update_cwnd(ack);
+}
+
+//! \details Losses are not read as congestion: they show up in the model as lower delivery rates.
+void BBR::on_loss(const uint64_t, const size_t) {}
+
+//! \details Nothing is known to be in flight any more, so the window restarts from a
+//! segment and grows back by what is acknowledged, up to what the model allows.
+void BBR::on_rto(const uint64_t, const size_t) { _cwnd = mss(); }
+
+double BBR::bottleneck_bandwidth() const {
+    double bandwidth = 0;
+    for (const auto &[round, rate] : _bw_samples) {
+        if (round + BW_WINDOW_ROUNDS > _round) {
+            bandwidth = max(bandwidth, rate);
+        }
+    }
+    return bandwidth;
+}
+
+uint64_t BBR::target_inflight(const double gain) const {
+    const double bandwidth = bottleneck_bandwidth();
+    if (bandwidth == 0 || _min_rtt_ms == 0) {
+        return 10 * mss();
+    }
+    return gain * bandwidth * _min_rtt_ms;
+}
+
+//! \details A round trip ends when a segment sent after it started is acknowledged.
+void BBR::update_round(const Ack &ack) {
+    _round_start = false;
+    if (ack.delivery_rate > 0 && ack.prior_delivered >= _next_round_delivered) {
+        _next_round_delivered = ack.delivered;
+        ++_round;
+        _round_start = true;
+    }
+}
+
+//! \details A sample limited by the writer only counts if it is higher than the estimate anyway.
+void BBR::update_bandwidth(const Ack &ack) {
+    if (ack.delivery_rate <= 0 || (ack.app_limited && ack.delivery_rate < bottleneck_bandwidth())) {
+        return;
+    }
+    auto &sample = _bw_samples[_round % BW_WINDOW_ROUNDS];
+    if (sample.first != _round) {
+        sample = {_round, ack.delivery_rate};
+    } else {
+        sample.second = max(sample.second, ack.delivery_rate);
+    }
+}
+
+//! \details The pipe is full once three round trips in a row fail to grow the bandwidth by a quarter.
+void BBR::check_full_pipe(const Ack &ack) {
+    if (_filled_pipe || !_round_start || ack.app_limited) {
+        return;
+    }
+    const double bandwidth = bottleneck_bandwidth();
+    if (bandwidth >= _full_bw * 1.25) {
+        _full_bw = bandwidth;
+        _full_bw_rounds = 0;
+    } else if (++_full_bw_rounds >= 3) {
+        _filled_pipe = true;
+    }
+}
+
+void BBR::enter_probe_bw(const size_t now_ms) {
+    _mode = Mode::ProbeBW;
+    _cwnd_gain = 2;
+    _cycle_index = 2;  // a phase at gain 1, as the queue has just been drained
+    _pacing_gain = PACING_GAIN_CYCLE[_cycle_index];
+    _cycle_stamp_ms = now_ms;
+}
+
+//! \details Each phase lasts about a round trip, but probing up lasts until it has put the extra
+//! data in flight (or met losses), and draining down ends as soon as the extra data is gone.
+void BBR::update_gain_cycle(const Ack &ack) {
+    if (_mode != Mode::ProbeBW) {
+        return;
+    }
+    const bool full_length = ack.now_ms - _cycle_stamp_ms > _min_rtt_ms;
+    bool advance = full_length;
+    if (_pacing_gain > 1) {
+        advance = full_length && (ack.in_recovery || ack.bytes_in_flight >= target_inflight(_pacing_gain));
+    } else if (_pacing_gain < 1) {
+        advance = full_length || ack.bytes_in_flight <= target_inflight(1);
+    }
+    if (advance) {
+        _cycle_index = (_cycle_index + 1) % PACING_GAIN_CYCLE.size();
+        _pacing_gain = PACING_GAIN_CYCLE[_cycle_index];
+        _cycle_stamp_ms = ack.now_ms;
+    }
+}
+
+//! \details When the round-trip time hasn't been seen to drop for ten seconds, ProbeRTT drains
+//! the queue for at least 200 ms and a round trip, so the next samples measure the path alone.
+void BBR::update_min_rtt(const Ack &ack) {
+    const bool expired = _min_rtt_ms != 0 && ack.now_ms > _min_rtt_stamp_ms + MIN_RTT_WINDOW_MS;
+    if (ack.rtt_ms > 0 && (_min_rtt_ms == 0 || ack.rtt_ms <= _min_rtt_ms || expired)) {
+        _min_rtt_ms = ack.rtt_ms;
+        _min_rtt_stamp_ms = ack.now_ms;
+    }
+
+    if (expired && _mode != Mode::ProbeRTT) {
+        _mode = Mode::ProbeRTT;
+        _pacing_gain = 1;
+        _cwnd_gain = 1;
+        _prior_cwnd = _cwnd;
+        _probe_rtt_done_ms = 0;
+    }
+    if (_mode != Mode::ProbeRTT) {
+        return;
+    }
+
+    if (_probe_rtt_done_ms == 0 && ack.bytes_in_flight <= MIN_CWND_SEGMENTS * mss()) {
+        _probe_rtt_done_ms = ack.now_ms + PROBE_RTT_DURATION_MS;
+        _probe_rtt_round_done = false;
+        _next_round_delivered = ack.delivered;
+    } else if (_probe_rtt_done_ms != 0) {
+        _probe_rtt_round_done = _probe_rtt_round_done || _round_start;
+        if (_probe_rtt_round_done && ack.now_ms >= _probe_rtt_done_ms) {
+            _min_rtt_stamp_ms = ack.now_ms;
+            _cwnd = max(_cwnd, _prior_cwnd);
+            if (_filled_pipe) {
+                enter_probe_bw(ack.now_ms);
+            } else {
+                _mode = Mode::Startup;
+                _pacing_gain = HIGH_GAIN;
+                _cwnd_gain = HIGH_GAIN;
+            }
+        }
+    }
+}
+
+//! \details Starts from the initial window over the first round-trip sample. Until the pipe is
+//! full, the rate only goes up, so that the small samples of the first round trips don't hold Startup back.
+void BBR::update_pacing_rate(const Ack &ack) {
+    if (_pacing_rate == 0 && ack.rtt_ms > 0) {
+        _pacing_rate = HIGH_GAIN * _cwnd / ack.rtt_ms;
+    }
+    const double rate = _pacing_gain * bottleneck_bandwidth();
+    if (rate > 0 && (_filled_pipe || rate > _pacing_rate)) {
+        _pacing_rate = rate;
+    }
+}
+
+//! \details Until the pipe is full, the window grows by what is acknowledged, as in slow start;
+//! afterwards, it follows the model's target.
+void BBR::update_cwnd(const Ack &ack) {
+    const uint64_t target = target_inflight(_cwnd_gain);
+    if (_filled_pipe) {
+        _cwnd = min(_cwnd + ack.acked_bytes, target);
+    } else if (_cwnd < target || ack.delivered < 10 * mss()) {
+        _cwnd += ack.acked_bytes;
+    }
+    _cwnd = max(_cwnd, MIN_CWND_SEGMENTS * mss());
+    if (_mode == Mode::ProbeRTT) {
+        _cwnd = min(_cwnd, MIN_CWND_SEGMENTS * mss());
+    }
+}
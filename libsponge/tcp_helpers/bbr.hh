@@ -0,0 +1,92 @@
+#ifndef SPONGE_LIBSPONGE_BBR_HH
+#define SPONGE_LIBSPONGE_BBR_HH
+
+#include "congestion_controller.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//! \brief Model-based congestion control, after BBR (draft-cardwell-iccrg-bbr-congestion-control)
+
+//! Rather than reading losses as congestion, BBR models the path from delivery-rate and
+//! round-trip samples: the bottleneck bandwidth (the highest delivery rate of the last ten
+//! round trips) and the propagation delay (the lowest round-trip time of the last ten seconds).
+//! It paces at a gain times the bandwidth, and caps what is in flight at a gain times their
+//! product, cycling through phases that measure each of them.
+class BBR : public CongestionController {
+  public:
+    //! The phases of BBR
+    enum class Mode {
+        Startup,   //!< Doubling the sending rate every round trip until the bandwidth stops growing
+        Drain,     //!< Draining the queue that Startup built
+        ProbeBW,   //!< Cycling the pacing gain around 1 to probe for more bandwidth
+        ProbeRTT,  //!< Briefly cutting what is in flight to measure the round-trip time without a queue
+    };
+
+  private:
+    static constexpr double HIGH_GAIN = 2.885;  //!< 2/ln(2): the smallest gain that doubles the rate per round trip
+    static constexpr std::array<double, 8> PACING_GAIN_CYCLE{1.25, 0.75, 1, 1, 1, 1, 1, 1};  //!< ProbeBW's gains
+    static constexpr size_t BW_WINDOW_ROUNDS = 10;         //!< Round trips over which the bandwidth is the max
+    static constexpr size_t MIN_RTT_WINDOW_MS = 10000;     //!< Time over which the round-trip time is the min
+    static constexpr size_t PROBE_RTT_DURATION_MS = 200;   //!< Time spent in ProbeRTT
+    static constexpr uint64_t MIN_CWND_SEGMENTS = 4;       //!< Smallest cwnd, also used in ProbeRTT
+
+    Mode _mode = Mode::Startup;
+    double _pacing_gain = HIGH_GAIN;
+    double _cwnd_gain = HIGH_GAIN;
+    uint64_t _cwnd;
+    uint64_t _prior_cwnd = 0;  //!< cwnd before ProbeRTT, to restore after
+    double _pacing_rate = 0;   //!< In bytes per millisecond, or 0 before the first round-trip sample
+
+    //! Highest delivery rate (bytes per ms) of each of the last round trips, with the round's number
+    std::array<std::pair<uint64_t, double>, BW_WINDOW_ROUNDS> _bw_samples{};
+    uint64_t _round = 0;                 //!< Round trips counted so far
+    uint64_t _next_round_delivered = 0;  //!< Delivered count that ends the current round trip
+    bool _round_start = false;           //!< Whether the last ack started a new round trip
+
+    size_t _min_rtt_ms = 0;        //!< Lowest round-trip time in the window, or 0 before the first sample
+    size_t _min_rtt_stamp_ms = 0;  //!< When it was measured
+
+    double _full_bw = 0;           //!< Bandwidth that Startup last grew by a quarter over
+    unsigned _full_bw_rounds = 0;  //!< Round trips since then
+    bool _filled_pipe = false;     //!< Whether Startup found the bottleneck bandwidth
+
+    size_t _cycle_index = 0;     //!< Phase of the ProbeBW gain cycle
+    size_t _cycle_stamp_ms = 0;  //!< When the phase started
+
+    size_t _probe_rtt_done_ms = 0;      //!< When ProbeRTT may end, or 0 until its cwnd has been reached
+    bool _probe_rtt_round_done = false;  //!< Whether a round trip has passed at the ProbeRTT cwnd
+
+    //! The bytes in flight that `gain` times the modelled bandwidth-delay product comes to
+    uint64_t target_inflight(const double gain) const;
+
+    void update_round(const Ack &ack);
+    void update_bandwidth(const Ack &ack);
+    void check_full_pipe(const Ack &ack);
+    void update_gain_cycle(const Ack &ack);
+    void update_min_rtt(const Ack &ack);
+    void enter_probe_bw(const size_t now_ms);
+    void update_cwnd(const Ack &ack);
+    void update_pacing_rate(const Ack &ack);
+
+  public:
+    //! Start with an initial window of 10 segments, in Startup
+    explicit BBR(const size_t mss) : CongestionController(mss), _cwnd(10 * mss) {}
+
+    void on_ack(const Ack &ack) override;
+    void on_loss(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    void on_rto(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+    double pacing_rate() const override { return _pacing_rate; }
+
+    //! \name Accessors
+    //!@{
+    Mode mode() const { return _mode; }
+    double bottleneck_bandwidth() const;  //!< In bytes per millisecond, or 0 before the first sample
+    size_t min_rtt_ms() const { return _min_rtt_ms; }
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_BBR_HH
@@ -0,0 +1,122 @@
+#include "congestion_controller.hh"
+
+#include "bbr.hh"
+#include "ledbat.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+void CongestionController::on_send(const size_t, const uint64_t, const size_t) {}
+
+unique_ptr<CongestionController> CongestionController::make(const TCPConfig::CongestionControl algorithm,
+                                                             const size_t mss) {
+    switch (algorithm) {
+        case TCPConfig::CongestionControl::NewReno:
+            return make_unique<NewReno>(mss);
+        case TCPConfig::CongestionControl::Cubic:
+            return make_unique<Cubic>(mss);
+        case TCPConfig::CongestionControl::BBR:
+            return make_unique<BBR>(mss);
+        case TCPConfig::CongestionControl::LEDBAT:
+            return make_unique<LEDBAT>(mss);
+        case TCPConfig::CongestionControl::None:
+            break;
+    }
+    return nullptr;
+}
+
+//! \details The window grows by up to a segment per acknowledgment in slow start, and by
+//! about a segment per window's worth of acknowledgments afterwards. In fast recovery, a
+//! partial acknowledgment takes back the inflation for the bytes it acknowledges, keeping
+//! a segment for the retransmission it triggers, and the one that completes the repair
+//! deflates the window to ssthresh (RFC 6582 section 3.2).
+void NewReno::on_ack(const Ack &ack) {
+    if (ack.in_recovery && ack.recovered) {
+        _cwnd = _ssthresh;
+        return;
+    }
+    if (ack.in_recovery) {
+        const uint64_t deflated = _cwnd - min(_cwnd, ack.acked_bytes);
+        _cwnd = max<uint64_t>(deflated + (ack.acked_bytes >= mss() ? mss() : 0), mss());
+        return;
+    }
+    if (_cwnd < _ssthresh) {
+        _cwnd += min<uint64_t>(ack.acked_bytes, mss());
+    } else {
+        _cwnd += max<uint64_t>(mss() * ack.acked_bytes / _cwnd, 1);
+    }
+}
+
+//! \details The window is inflated by the three segments that the duplicate acknowledgments
+//! say have left the network (RFC 5681 section 3.2).
+void NewReno::on_loss(const uint64_t bytes_in_flight, const size_t) {
+    _ssthresh = max<uint64_t>(bytes_in_flight / 2, 2 * mss());
+    _cwnd = _ssthresh + 3 * mss();
+}
+
+void NewReno::on_rto(const uint64_t bytes_in_flight, const size_t) {
+    _ssthresh = max<uint64_t>(bytes_in_flight / 2, 2 * mss());
+    _cwnd = mss();
+}
+
+//! \details After slow start, the window follows W(t) = C * (t - K)^3 + W_max, aiming one
+//! round trip ahead, but never grows slower than Reno would have (the "Reno-friendly" region).
+void Cubic::on_ack(const Ack &ack) {
+    if (ack.rtt_ms > 0) {
+        _srtt_ms = _srtt_ms == 0 ? ack.rtt_ms : (7 * _srtt_ms + ack.rtt_ms) / 8;
+    }
+    if (ack.in_recovery) {
+        return;
+    }
+    if (_cwnd < _ssthresh) {
+        _cwnd += min<uint64_t>(ack.acked_bytes, mss());
+        return;
+    }
+    if (not _in_epoch) {
+        start_epoch(ack.now_ms);
+    }
+
+    const double window = double(_cwnd) / mss();
+    const double acked = double(ack.acked_bytes) / mss();
+    const double t = double(ack.now_ms - _epoch_start_ms + _srtt_ms) / 1000;
+    double target = C * pow(t - _k, 3) + _w_max;
+    _w_est += 3 * (1 - BETA) / (1 + BETA) * acked / window;
+    target = min(max(target, _w_est), 1.5 * window);
+    if (target > window) {
+        _cwnd += max<uint64_t>((target - window) / window * ack.acked_bytes, 1);
+    }
+}
+
+void Cubic::start_epoch(const size_t now_ms) {
+    const double window = double(_cwnd) / mss();
+    _in_epoch = true;
+    _epoch_start_ms = now_ms;
+    _w_est = window;
+    if (_w_max <= window) {
+        _w_max = window;
+        _k = 0;
+    } else {
+        _k = cbrt((_w_max - window) / C);
+    }
+}
+
+//! \details With fast convergence: a loss below the previous W_max suggests that other
+//! flows have taken bandwidth, so this flow aims lower, releasing some.
+void Cubic::reduce() {
+    const double window = double(_cwnd) / mss();
+    _w_max = window < _w_max ? window * (1 + BETA) / 2 : window;
+    _ssthresh = max<uint64_t>(_cwnd * BETA, 2 * mss());
+    _in_epoch = false;
+}
+
+void Cubic::on_loss(const uint64_t, const size_t) {
+    reduce();
+    _cwnd = _ssthresh;
+}
+
+void Cubic::on_rto(const uint64_t, const size_t) {
+    reduce();
+    _cwnd = mss();
+}
@@ -0,0 +1,140 @@
+#ifndef SPONGE_LIBSPONGE_CONGESTION_CONTROLLER_HH
+#define SPONGE_LIBSPONGE_CONGESTION_CONTROLLER_HH
+
+#include "tcp_config.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+//! \brief The congestion-control algorithm of a TCPSender
+
+//! The TCPSender tells its controller about the segments it sends, the acknowledgments,
+//! the losses it detects and its retransmission timeouts, and sends no more than
+//! cwnd() bytes (in sequence space) at a time. All amounts are in bytes, all times
+//! in milliseconds as told by TCPSender::tick().
+class CongestionController {
+  public:
+    //! What an acknowledgment of new data tells the controller
+    struct Ack {
+        uint64_t acked_bytes = 0;      //!< Bytes newly acknowledged
+        uint64_t bytes_in_flight = 0;  //!< Bytes still in flight after the acknowledgment
+        size_t rtt_ms = 0;             //!< Round-trip time sampled by this acknowledgment, or 0 if none
+        size_t now_ms = 0;             //!< Time of the acknowledgment
+        bool in_recovery = false;      //!< Whether the sender was in fast recovery (even if this ack completes it)
+        bool recovered = false;        //!< Whether this ack completes the repair of a loss
+        uint64_t delivered = 0;        //!< Bytes acknowledged so far, this ack included
+        uint64_t prior_delivered = 0;  //!< `delivered` when the newest segment this ack acknowledges was sent
+        double delivery_rate = 0;      //!< Bytes per millisecond delivered over that segment's flight, or 0 if unknown
+        bool app_limited = false;      //!< Whether the writer, not the network, limited `delivery_rate`
+    };
+
+    //! \param[in] mss is the largest payload the sender puts in a segment
+    explicit CongestionController(const size_t mss) : _mss(mss) {}
+    virtual ~CongestionController() = default;
+
+    //! \name
+    //! Controllers are only handled through pointers
+    //!@{
+    CongestionController(const CongestionController &other) = delete;
+    CongestionController &operator=(const CongestionController &other) = delete;
+    //!@}
+
+    //! A new segment of `bytes` (in sequence space) was sent at `now_ms`, leaving `bytes_in_flight` in flight
+    virtual void on_send(const size_t bytes, const uint64_t bytes_in_flight, const size_t now_ms);
+
+    //! New data was acknowledged
+    virtual void on_ack(const Ack &ack) = 0;
+
+    //! A loss was detected by duplicate acknowledgments, with `bytes_in_flight` in flight; called once per window
+    virtual void on_loss(const uint64_t bytes_in_flight, const size_t now_ms) = 0;
+
+    //! A further duplicate acknowledgment arrived in fast recovery: another segment has left the network
+    virtual void on_duplicate_ack() {}
+
+    //! The retransmission timer expired, with `bytes_in_flight` in flight
+    virtual void on_rto(const uint64_t bytes_in_flight, const size_t now_ms) = 0;
+
+    //! The most bytes that may be in flight
+    virtual uint64_t cwnd() const = 0;
+
+    //! The rate, in bytes per millisecond, at which to space out segments, or 0 to send them as the window allows
+    virtual double pacing_rate() const { return 0; }
+
+    //! How fast to space out segments when pacing_rate() is 0 but TCPConfig::pacing is set,
+    //! as a multiple of cwnd() per smoothed round trip
+    virtual double pacing_gain() const { return 1; }
+
+    //! The largest payload the sender puts in a segment
+    size_t mss() const { return _mss; }
+
+    //! Make the controller selected by `algorithm`
+    //! \returns nullptr for TCPConfig::CongestionControl::None
+    static std::unique_ptr<CongestionController> make(const TCPConfig::CongestionControl algorithm, const size_t mss);
+
+  private:
+    size_t _mss;
+};
+
+//! \brief Slow start, then additive increase and multiplicative decrease (RFC 5681, RFC 6582)
+class NewReno : public CongestionController {
+  private:
+    uint64_t _cwnd;                   //!< Congestion window
+    uint64_t _ssthresh = UINT64_MAX;  //!< Slow-start threshold
+
+  public:
+    //! Start with an initial window of 10 segments (RFC 6928)
+    explicit NewReno(const size_t mss) : CongestionController(mss), _cwnd(10 * mss) {}
+
+    void on_ack(const Ack &ack) override;
+    void on_loss(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    void on_duplicate_ack() override { _cwnd += mss(); }
+    void on_rto(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+
+    //! Twice the window per round trip in slow start, so pacing doesn't hold its growth back,
+    //! and a fifth more afterwards (as in Linux)
+    double pacing_gain() const override { return _cwnd < _ssthresh ? 2 : 1.2; }
+
+    //! The slow-start threshold
+    uint64_t ssthresh() const { return _ssthresh; }
+};
+
+//! \brief A window that grows as a cubic function of the time since the last loss (RFC 9438)
+class Cubic : public CongestionController {
+  private:
+    static constexpr double C = 0.4;     //!< Aggressiveness of the cubic growth, in segments per second cubed
+    static constexpr double BETA = 0.7;  //!< Fraction of the window kept after a loss
+
+    uint64_t _cwnd;                   //!< Congestion window
+    uint64_t _ssthresh = UINT64_MAX;  //!< Slow-start threshold
+    double _w_max = 0;                //!< Window (in segments) at the last loss
+    double _w_est = 0;                //!< Window (in segments) that Reno would have reached since then
+    double _k = 0;                    //!< Seconds after the loss at which the cubic curve reaches _w_max
+    bool _in_epoch = false;           //!< Whether congestion avoidance has started since the last loss
+    size_t _epoch_start_ms = 0;       //!< When it did
+    size_t _srtt_ms = 0;              //!< Smoothed round-trip time, to aim a round trip ahead
+
+    //! Leave slow start or a loss behind: start a new cubic curve at `now_ms`
+    void start_epoch(const size_t now_ms);
+
+    //! Record a loss, as the start of a new curve
+    void reduce();
+
+  public:
+    //! Start with an initial window of 10 segments (RFC 6928)
+    explicit Cubic(const size_t mss) : CongestionController(mss), _cwnd(10 * mss) {}
+
+    void on_ack(const Ack &ack) override;
+    void on_loss(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    void on_rto(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+
+    //! As NewReno::pacing_gain()
+    double pacing_gain() const override { return _cwnd < _ssthresh ? 2 : 1.2; }
+
+    //! The slow-start threshold
+    uint64_t ssthresh() const { return _ssthresh; }
+};
+
+#endif  // SPONGE_LIBSPONGE_CONGESTION_CONTROLLER_HH
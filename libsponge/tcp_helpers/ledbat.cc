@@ -0,0 +1,58 @@
+#include "ledbat.hh"
+
+#include <algorithm>
+
+using namespace std;
+
+//! \details The window moves by GAIN segments per round trip times how far the queueing delay is
+//! under the target (or, with a negative sign, over it), and may not run ahead of what is in flight.
+void LEDBAT::on_ack(const Ack &ack) {
+    if (ack.rtt_ms > 0) {
+        add_delay_sample(ack.rtt_ms, ack.now_ms);
+    }
+    if (current_delay_ms() == 0) {
+        return;
+    }
+    const double off_target = (double(TARGET_MS) - double(queueing_delay_ms())) / TARGET_MS;
+    _cwnd += GAIN * off_target * ack.acked_bytes * mss() / _cwnd;
+    _cwnd = min(_cwnd, double(ack.bytes_in_flight + ack.acked_bytes + ALLOWED_INCREASE * mss()));
+    _cwnd = max(_cwnd, double(MIN_CWND_SEGMENTS * mss()));
+}
+
+void LEDBAT::on_loss(const uint64_t, const size_t) { _cwnd = max(_cwnd / 2, double(MIN_CWND_SEGMENTS * mss())); }
+
+void LEDBAT::on_rto(const uint64_t, const size_t) { _cwnd = mss(); }
+
+size_t LEDBAT::base_delay_ms() const {
+    size_t delay = 0;
+    for (const auto &[minute, rtt_ms] : _base_delays) {
+        if (rtt_ms != 0 && minute + BASE_HISTORY > _minute && (delay == 0 || rtt_ms < delay)) {
+            delay = rtt_ms;
+        }
+    }
+    return delay;
+}
+
+size_t LEDBAT::current_delay_ms() const {
+    size_t delay = 0;
+    for (const size_t rtt_ms : _current_delays) {
+        if (rtt_ms != 0 && (delay == 0 || rtt_ms < delay)) {
+            delay = rtt_ms;
+        }
+    }
+    return delay;
+}
+
+//! \details Each minute has its own slot in the base-delay history, so a route change that
+//! lengthens the path is picked up once the minutes from before it have rolled out.
+void LEDBAT::add_delay_sample(const size_t rtt_ms, const size_t now_ms) {
+    _current_delays[_current_index] = rtt_ms;
+    _current_index = (_current_index + 1) % CURRENT_FILTER;
+
+    _minute = now_ms / BASE_INTERVAL_MS;
+    auto &[slot_minute, slot_rtt_ms] = _base_delays[_minute % BASE_HISTORY];
+    if (slot_minute != _minute || slot_rtt_ms == 0 || rtt_ms < slot_rtt_ms) {
+        slot_minute = _minute;
+        slot_rtt_ms = rtt_ms;
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef SPONGE_LIBSPONGE_LEDBAT_HH
+#define SPONGE_LIBSPONGE_LEDBAT_HH
+
+#include "congestion_controller.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//! \brief Scavenger congestion control for background transfers, after LEDBAT (RFC 6817)
+
+//! LEDBAT yields to every other flow at the bottleneck. It takes the lowest round-trip time
+//! seen in the last ten minutes as the path's base delay, and anything above it as queueing.
+//! The window grows while the queueing delay is under a small target and shrinks, in
+//! proportion, as soon as it goes over: the flow backs off from the queues it would build,
+//! and from those that others build, long before a loss-based flow would notice any loss.
+//! Round trips stand in for the one-way delays of the RFC, as segments carry no timestamps.
+class LEDBAT : public CongestionController {
+  private:
+    static constexpr size_t TARGET_MS = 25;            //!< Queueing delay aimed for (RFC 6817 allows up to 100 ms)
+    static constexpr double GAIN = 1;                  //!< Growth per round trip at no queueing delay, in segments
+    static constexpr uint64_t MIN_CWND_SEGMENTS = 2;   //!< Smallest cwnd
+    static constexpr uint64_t ALLOWED_INCREASE = 1;    //!< Segments by which cwnd may exceed what is in flight
+    static constexpr size_t CURRENT_FILTER = 4;        //!< Samples whose min is the current delay
+    static constexpr size_t BASE_HISTORY = 10;         //!< Minutes over which the base delay is the min
+    static constexpr size_t BASE_INTERVAL_MS = 60000;  //!< Length of each of them
+
+    double _cwnd;  //!< Congestion window, with the fractions of a byte that growth accumulates
+
+    std::array<size_t, CURRENT_FILTER> _current_delays{};  //!< Latest round-trip samples, 0 where none yet
+    size_t _current_index = 0;                             //!< Where the next one goes
+
+    //! Lowest round-trip sample of each of the last minutes, with the minute's number
+    std::array<std::pair<size_t, size_t>, BASE_HISTORY> _base_delays{};
+    size_t _minute = 0;  //!< Minute of the latest sample
+
+    //! Add a round-trip sample `rtt_ms` taken at `now_ms` to both filters
+    void add_delay_sample(const size_t rtt_ms, const size_t now_ms);
+
+  public:
+    //! Start with an initial window of 2 segments (RFC 6817 section 2.4.2)
+    explicit LEDBAT(const size_t mss) : CongestionController(mss), _cwnd(MIN_CWND_SEGMENTS * mss) {}
+
+    void on_ack(const Ack &ack) override;
+    void on_loss(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    void on_rto(const uint64_t bytes_in_flight, const size_t now_ms) override;
+    uint64_t cwnd() const override { return _cwnd; }
+
+    //! \name Accessors
+    //!@{
+    size_t base_delay_ms() const;     //!< Lowest round-trip time in the history, or 0 before the first sample
+    size_t current_delay_ms() const;  //!< Lowest of the latest round-trip samples, or 0 before the first one
+    //! Round-trip time over the base delay, taken as the delay that queues add
+    size_t queueing_delay_ms() const { return current_delay_ms() - base_delay_ms(); }
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_LEDBAT_HH
@@ -2,10 +2,14 @@
 #define SPONGE_LIBSPONGE_TCP_CONFIG_HH
 
 #include "address.hh"
+#include "byte_stream.hh"
+#include "tcp_memory_accountant.hh"
 #include "wrapping_integers.hh"
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <memory>
 #include <optional>
 
 //! Config for TCP sender and receiver
@@ -14,11 +18,43 @@ class TCPConfig {
     static constexpr size_t DEFAULT_CAPACITY = 64000;  //!< Default capacity
     static constexpr size_t MAX_PAYLOAD_SIZE = 1452;   //!< Max TCP payload that fits in either IPv4 or UDP datagram
     static constexpr uint16_t TIMEOUT_DFLT = 1000;     //!< Default re-transmit timeout is 1 second
+    static constexpr uint16_t RTO_MIN_DFLT = 20;       //!< Default smallest adaptive timeout: two ticks of TCPSpongeSocket
+    static constexpr uint16_t RTO_MAX_DFLT = 60000;    //!< Default largest adaptive timeout (RFC 6298 section 2.5)
     static constexpr unsigned MAX_RETX_ATTEMPTS = 8;   //!< Maximum re-transmit attempts before giving up
+    static constexpr size_t MAX_WINDOW = 65535;        //!< Largest window a TCPHeader can advertise (no window scaling)
+
+    //! Congestion-control algorithms for the sender (see CongestionController)
+    enum class CongestionControl {
+        None,     //!< Send as much as the receiver's window allows
+        NewReno,  //!< Loss-based additive increase, multiplicative decrease
+        Cubic,    //!< Loss-based, with a window that grows as a cubic function of time
+        BBR,      //!< Model-based, pacing at the estimated bottleneck bandwidth
+        LEDBAT,   //!< Delay-based scavenger, yielding to other flows before queues build up
+    };
 
     uint16_t rt_timeout = TIMEOUT_DFLT;       //!< Initial value of the retransmission timeout, in milliseconds
+    //! Whether the retransmission timeout adapts to the measured round-trip time (RFC 6298),
+    //! rather than going back to rt_timeout on every acknowledgment
+    bool adaptive_rto = false;
+    uint16_t rto_min = RTO_MIN_DFLT;  //!< Smallest adaptive retransmission timeout, in milliseconds
+    uint16_t rto_max = RTO_MAX_DFLT;  //!< Largest adaptive retransmission timeout, backoff included, in milliseconds
     size_t recv_capacity = DEFAULT_CAPACITY;  //!< Receive capacity, in bytes
+    //! Largest receive capacity that auto-tuning may grow to (no auto-tuning unless above recv_capacity)
+    size_t recv_capacity_max = 0;
     size_t send_capacity = DEFAULT_CAPACITY;  //!< Sender capacity, in bytes
+    //! Largest sender capacity that auto-tuning may grow to (no auto-tuning unless above send_capacity)
+    size_t send_capacity_max = 0;
+    ByteStream::Storage send_storage = ByteStream::Storage::Ring;  //!< How the outbound stream stores its bytes
+    CongestionControl congestion_control = CongestionControl::None;  //!< How the sender reacts to congestion
+    //! Whether the sender spaces its segments out over the round trip, even if the congestion
+    //! control has no pacing rate of its own (see CongestionController::pacing_gain())
+    bool pacing = false;
+    size_t pacing_max_burst = 2 * MAX_PAYLOAD_SIZE;  //!< Most bytes that pacing lets go back to back, in bytes
+    ByteStream::Storage recv_storage = ByteStream::Storage::Ring;  //!< How the inbound stream stores its bytes
+    //! Most memory that out-of-order payloads may keep alive (see StreamReassembler::resident_bytes())
+    size_t recv_memory_budget = std::numeric_limits<size_t>::max();
+    //! Receive memory shared with other connections, if any (see TCPMemoryAccountant)
+    std::shared_ptr<TCPMemoryAccountant> recv_memory_accountant{};
     std::optional<WrappingInt32> fixed_isn{};
 };
 
@@ -0,0 +1,52 @@
+#include "tcp_memory_accountant.hh"
+
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+TCPMemoryAccountant::TCPMemoryAccountant(const size_t limit, const size_t pressure_threshold)
+    : _pressure_threshold(pressure_threshold), _limit(limit) {
+    if (pressure_threshold > limit) {
+        throw runtime_error("TCPMemoryAccountant: pressure threshold is above the limit");
+    }
+}
+
+TCPMemoryAccountant::Pressure TCPMemoryAccountant::pressure() const {
+    const size_t charged = _charged;
+    if (charged >= _limit) {
+        return Pressure::Critical;
+    }
+    if (charged >= _pressure_threshold) {
+        return Pressure::Moderate;
+    }
+    return Pressure::None;
+}
+
+TCPMemoryCharge::TCPMemoryCharge(TCPMemoryCharge &&other) noexcept
+    : _accountant(move(other._accountant)), _bytes(exchange(other._bytes, 0)) {}
+
+TCPMemoryCharge &TCPMemoryCharge::operator=(TCPMemoryCharge &&other) noexcept {
+    if (this != &other) {
+        set(0);
+        _accountant = move(other._accountant);
+        _bytes = exchange(other._bytes, 0);
+    }
+    return *this;
+}
+
+void TCPMemoryCharge::set(const size_t bytes) {
+    if (not _accountant) {
+        return;
+    }
+    if (bytes > _bytes) {
+        _accountant->charge(bytes - _bytes);
+    } else {
+        _accountant->uncharge(_bytes - bytes);
+    }
+    _bytes = bytes;
+}
+
+TCPMemoryAccountant::Pressure TCPMemoryCharge::pressure() const {
+    return _accountant ? _accountant->pressure() : TCPMemoryAccountant::Pressure::None;
+}
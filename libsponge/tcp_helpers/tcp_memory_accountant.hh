@@ -0,0 +1,87 @@
+#ifndef SPONGE_LIBSPONGE_TCP_MEMORY_ACCOUNTANT_HH
+#define SPONGE_LIBSPONGE_TCP_MEMORY_ACCOUNTANT_HH
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+//! \brief Receive memory shared by many connections, like Linux's `tcp_mem`
+
+//! Each TCPReceiver that is given the same accountant (through TCPConfig::recv_memory_accountant)
+//! charges it with the bytes it holds: those reassembled but not yet read, and those waiting
+//! to be reassembled. The total decides the pressure() that every receiver reacts to.
+//! Connections may run on different threads, so the total is kept atomically.
+class TCPMemoryAccountant {
+  private:
+    size_t _pressure_threshold;        //!< Total at which Pressure::Moderate begins
+    size_t _limit;                     //!< Total at which Pressure::Critical begins
+    std::atomic<size_t> _charged{0};  //!< Bytes charged by all receivers
+
+  public:
+    //! How tight the shared budget is
+    enum class Pressure {
+        None,      //!< Below the pressure threshold: receivers behave as if there were no accountant
+        Moderate,  //!< Between the threshold and the limit: receivers offer half their free space
+        Critical   //!< At or over the limit: receivers open no new window and drop out-of-order data
+    };
+
+    //! \param[in] limit is the total at which the budget is exhausted
+    //! \param[in] pressure_threshold is the total at which receivers start to hold back
+    TCPMemoryAccountant(const size_t limit, const size_t pressure_threshold);
+
+    //! A budget of `limit` bytes that comes under pressure at three quarters full
+    explicit TCPMemoryAccountant(const size_t limit) : TCPMemoryAccountant(limit, limit / 4 * 3) {}
+
+    //! Add `bytes` to the total
+    void charge(const size_t bytes) { _charged += bytes; }
+
+    //! Take `bytes` (previously charged) off the total
+    void uncharge(const size_t bytes) { _charged -= bytes; }
+
+    //! \name Accessors
+    //!@{
+    size_t charged() const { return _charged; }
+    size_t limit() const { return _limit; }
+    size_t pressure_threshold() const { return _pressure_threshold; }
+    Pressure pressure() const;
+    //!@}
+};
+
+//! \brief One receiver's share of a TCPMemoryAccountant
+
+//! Keeps the accountant charged with the last amount set(), and uncharges it on destruction.
+//! Without an accountant, it does nothing and the pressure is always Pressure::None.
+class TCPMemoryCharge {
+  private:
+    std::shared_ptr<TCPMemoryAccountant> _accountant;
+    size_t _bytes = 0;  //!< What this share currently charges the accountant
+
+  public:
+    explicit TCPMemoryCharge(std::shared_ptr<TCPMemoryAccountant> accountant = nullptr)
+        : _accountant(std::move(accountant)) {}
+
+    //! Uncharge this share
+    ~TCPMemoryCharge() { set(0); }
+
+    //! \name
+    //! A TCPMemoryCharge cannot be copied (which would charge twice), but can be moved
+
+    //!@{
+    TCPMemoryCharge(const TCPMemoryCharge &other) = delete;
+    TCPMemoryCharge &operator=(const TCPMemoryCharge &other) = delete;
+    TCPMemoryCharge(TCPMemoryCharge &&other) noexcept;
+    TCPMemoryCharge &operator=(TCPMemoryCharge &&other) noexcept;
+    //!@}
+
+    //! Charge the accountant `bytes` in total for this share
+    void set(const size_t bytes);
+
+    //! \name Accessors
+    //!@{
+    size_t bytes() const { return _bytes; }
+    TCPMemoryAccountant::Pressure pressure() const;
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_TCP_MEMORY_ACCOUNTANT_HH
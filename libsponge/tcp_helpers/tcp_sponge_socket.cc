@@ -4,6 +4,7 @@
 #include "tun.hh"
 #include "util.hh"
 
+#include <algorithm>
 #include <cstddef>
 #include <exception>
 #include <iostream>
@@ -24,7 +25,12 @@ template <typename AdaptT>
 void TCPSpongeSocket<AdaptT>::_tcp_loop(const function<bool()> &condition) {
     auto base_time = timestamp_ms();
     while (condition()) {
-        auto ret = _eventloop.wait_next_event(TCP_TICK_MS);
+        // wake up early if the sender is pacing segments out
+        size_t timeout = TCP_TICK_MS;
+        if (_tcp.has_value() and _tcp.value().time_until_send().has_value()) {
+            timeout = min(timeout, _tcp.value().time_until_send().value());
+        }
+        auto ret = _eventloop.wait_next_event(timeout);
         if (ret == EventLoop::Result::Exit or _abort) {
             break;
         }
@@ -95,12 +101,7 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
         _thread_data,
         Direction::In,
         [&] {
-            const auto data = _thread_data.read(_tcp->remaining_outbound_capacity());
-            const auto len = data.size();
-            const auto amount_written = _tcp->write(move(data));
-            if (amount_written != len) {
-                throw runtime_error("TCPConnection::write() accepted less than advertised length");
-            }
+            _tcp->write_from(_thread_data);
 
             if (_thread_data.eof()) {
                 _tcp->end_input_stream();
@@ -127,10 +128,7 @@ void TCPSpongeSocket<AdaptT>::_initialize_TCP(const TCPConfig &config) {
             // Write from the inbound_stream into
             // the pipe, handling the possibility of a partial
             // write (i.e., only pop what was actually written).
-            const size_t amount_to_write = min(size_t(65536), inbound.buffer_size());
-            const std::string buffer = inbound.peek_output(amount_to_write);
-            const auto bytes_written = _thread_data.write(move(buffer), false);
-            inbound.pop_output(bytes_written);
+            inbound.write_to(_thread_data);
 
             if (inbound.eof() or inbound.error()) {
                 _thread_data.shutdown(SHUT_WR);
@@ -5,7 +5,39 @@
 
 using namespace std;
 
-void TCPReceiver::segment_received(const TCPSegment &seg) {
+// Config carrying only the fields that the classic TCPReceiver constructor takes.
+static TCPConfig receiver_config(const size_t capacity, const ByteStream::Storage storage, const size_t memory_budget) {
+  TCPConfig config;
+  config.recv_capacity = capacity;
+  config.recv_storage = storage;
+  config.recv_memory_budget = memory_budget;
+  return config;
+}
+
+//! \param capacity the maximum number of bytes that the receiver will store in its buffers at any give time.
+//! \param storage how the inbound stream stores its bytes
+//! \param memory_budget the most memory that out-of-order payloads may keep alive
+TCPReceiver::TCPReceiver(const size_t capacity, const ByteStream::Storage storage, const size_t memory_budget) :
+  TCPReceiver(receiver_config(capacity, storage, memory_budget)) {}
+
+//! \param config the TCPConfig whose recv_capacity, recv_storage, recv_memory_budget and recv_memory_accountant are used
+TCPReceiver::TCPReceiver(const TCPConfig &config) :
+  has_met_syn_(false),
+  isn_(0),
+  reassembler_(config.recv_capacity, config.recv_storage, config.recv_memory_budget),
+  capacity_(config.recv_capacity),
+  memory_charge_(config.recv_memory_accountant),
+  window_edge_(0),
+  capacity_max_(max(config.recv_capacity, config.recv_capacity_max)),
+  time_ms_(0),
+  rtt_ms_(0),
+  rtt_measuring_(false),
+  rtt_end_index_(0),
+  rtt_start_ms_(0),
+  space_start_ms_(0),
+  space_start_read_(0) {}
+
+uint64_t TCPReceiver::stream_index(const TCPSegment &seg) {
   const TCPHeader& header = seg.header();
   WrappingInt32 seqno = header.seqno;
   if (header.syn) {
@@ -15,9 +47,83 @@ void TCPReceiver::segment_received(const TCPSegment &seg) {
   }
   size_t checkpoint = reassembler_.stream_out().bytes_written();
   size_t abs_seqno_64 = unwrap(seqno, isn_, checkpoint);
-  size_t stream_index = abs_seqno_64 - 1;
-  string data = seg.payload().copy();
-  reassembler_.push_substring(data, stream_index, header.fin);
+  return abs_seqno_64 - 1;
+}
+
+//! \details Like Linux's tcp_prune_queue under tcp_memory_pressure: out-of-order bytes are the
+//! first to go, and the sender will retransmit them once the pressure eases.
+void TCPReceiver::account_memory() {
+  memory_charge_.set(reassembler_.stream_out().buffer_size() + reassembler_.resident_bytes());
+  if (memory_charge_.pressure() == TCPMemoryAccountant::Pressure::Critical) {
+    reassembler_.discard_unassembled();
+    memory_charge_.set(reassembler_.stream_out().buffer_size());
+  }
+}
+
+//! \details Like Linux's tcp_rcv_rtt_measure, for a receiver that sees no timestamps: the sender
+//! cannot go past the window until it hears about more, so filling it takes at least a round trip.
+//! A sender that has less to send makes the estimate longer, and the tuning more cautious.
+void TCPReceiver::measure_rtt() {
+  const uint64_t written = reassembler_.stream_out().bytes_written();
+  if (rtt_measuring_ && written >= rtt_end_index_) {
+    const size_t sample = max<size_t>(time_ms_ - rtt_start_ms_, 1);
+    // quick to follow a shorter round trip, slow to follow a longer one
+    rtt_ms_ = rtt_ms_ == 0 || sample < rtt_ms_ ? sample : (7 * rtt_ms_ + sample) / 8;
+    rtt_measuring_ = false;
+  }
+  const size_t window = min(window_size(), TCPConfig::MAX_WINDOW);  // as it will be advertised
+  if (!rtt_measuring_ && window > 0) {
+    rtt_end_index_ = written + window;
+    rtt_start_ms_ = time_ms_;
+    rtt_measuring_ = true;
+  }
+}
+
+//! \details Twice the bytes drained per round trip leaves the sender a full window while
+//! the reader works through the previous one. Growth is held back while the shared
+//! receive memory is under pressure, and the capacity never shrinks.
+void TCPReceiver::adjust_capacity() {
+  if (rtt_ms_ == 0 || time_ms_ - space_start_ms_ < rtt_ms_) {
+    return;
+  }
+  const uint64_t read = reassembler_.stream_out().bytes_read();
+  const size_t wanted = min(2 * (read - space_start_read_), capacity_max_);
+  if (wanted > capacity_ && memory_charge_.pressure() == TCPMemoryAccountant::Pressure::None) {
+    capacity_ = wanted;
+    reassembler_.grow_capacity(capacity_);
+  }
+  space_start_ms_ = time_ms_;
+  space_start_read_ = read;
+}
+
+void TCPReceiver::segment_received(const TCPSegment &seg) {
+  uint64_t index = stream_index(seg);
+  reassembler_.push_substring(seg.payload(), index, seg.header().fin);
+  account_memory();
+  if (capacity_max_ > capacity_ && has_met_syn_) {
+    measure_rtt();
+  }
+}
+
+void TCPReceiver::segments_received(const vector<TCPSegment> &segs) {
+  vector<StreamReassembler::Excerpt> excerpts;
+  excerpts.reserve(segs.size());
+  for (const TCPSegment &seg : segs) {
+    uint64_t index = stream_index(seg);
+    excerpts.push_back({seg.payload(), index, seg.header().fin});
+  }
+  reassembler_.push_substrings(excerpts);
+  account_memory();
+  if (capacity_max_ > capacity_ && has_met_syn_) {
+    measure_rtt();
+  }
+}
+
+void TCPReceiver::tick(const size_t ms_since_last_tick) {
+  time_ms_ += ms_since_last_tick;
+  if (capacity_max_ > capacity_) {
+    adjust_capacity();
+  }
 }
 
 // Note:
@@ -33,7 +139,31 @@ optional<WrappingInt32> TCPReceiver::ackno() const {
     WrappingInt32(wrap(nwrite + 1, isn_));  // considering SYN
 }
 
+size_t TCPReceiver::offered_window() const {
+  const ByteStream &stream = reassembler_.stream_out();
+  const size_t window = stream.bytes_read() + capacity_ - stream.bytes_written();
+  switch (memory_charge_.pressure()) {
+    case TCPMemoryAccountant::Pressure::None:
+      break;
+    case TCPMemoryAccountant::Pressure::Moderate:
+      return window / 2;
+    case TCPMemoryAccountant::Pressure::Critical:
+      return 0;
+  }
+  return window;
+}
+
 // Reference: https://cs144.github.io/assignments/lab1.pdf
+// RFC 1122 4.2.2.16: the right edge of the window must not move back.
 size_t TCPReceiver::window_size() const {
-  return reassembler_.stream_out().bytes_read() + capacity_ - reassembler_.stream_out().bytes_written();
+  const uint64_t written = reassembler_.stream_out().bytes_written();
+  return max<uint64_t>(offered_window(), window_edge_ > written ? window_edge_ - written : 0);
+}
+
+size_t TCPReceiver::advertise_window(const size_t max_window) {
+  const ByteStream &stream = reassembler_.stream_out();
+  memory_charge_.set(stream.buffer_size() + reassembler_.resident_bytes());
+  const size_t window = min(window_size(), max_window);
+  window_edge_ = max(window_edge_, stream.bytes_written() + window);
+  return window;
 }
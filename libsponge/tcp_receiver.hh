@@ -3,10 +3,14 @@
 
 #include "byte_stream.hh"
 #include "stream_reassembler.hh"
+#include "tcp_config.hh"
+#include "tcp_memory_accountant.hh"
 #include "tcp_segment.hh"
 #include "wrapping_integers.hh"
 
+#include <limits>
 #include <optional>
+#include <vector>
 
 //! \brief The "receiver" part of a TCP implementation.
 
@@ -33,16 +37,51 @@ class TCPReceiver {
     //! The maximum number of bytes we'll store.
     size_t capacity_;
 
+    //! Our share of the receive memory shared with other connections, if any.
+    TCPMemoryCharge memory_charge_;
+
+    //! The stream index just past the furthest window advertised (see advertise_window()), which is never taken back.
+    uint64_t window_edge_;
+
+    // Receive buffer auto-tuning (dynamic right-sizing, as in Linux's tcp_rcv_space_adjust).
+    size_t capacity_max_;        // the capacity never grows beyond this
+    size_t time_ms_;             // time elapsed, as told by tick()
+    size_t rtt_ms_;              // estimated round-trip time, or 0 before the first sample
+    bool rtt_measuring_;         // whether a round trip is being timed
+    uint64_t rtt_end_index_;     // the round trip ends once the window advertised at its start is filled
+    size_t rtt_start_ms_;        // when the round trip being timed started
+    size_t space_start_ms_;      // when the current measurement of the reader's pace started
+    uint64_t space_start_read_;  // bytes_read() then
+
+    //! Note the ISN if `seg` carries a SYN, and find the stream index of its payload.
+    uint64_t stream_index(const TCPSegment &seg);
+
+    //! Charge the shared budget with the bytes now held, then drop out-of-order bytes if it is exhausted.
+    void account_memory();
+
+    //! The free capacity, cut down while the shared receive memory is under pressure.
+    size_t offered_window() const;
+
+    //! Time how long the sender takes to fill an advertised window, which is about one round trip.
+    void measure_rtt();
+
+    //! Once per round trip, grow the capacity to twice what the reader drained in it.
+    void adjust_capacity();
+
   public:
     //! \brief Construct a TCP receiver
     //!
     //! \param capacity the maximum number of bytes that the receiver will
     //!                 store in its buffers at any give time.
-    TCPReceiver(const size_t capacity) :
-      has_met_syn_(false),
-      isn_(0),
-      reassembler_(capacity),
-      capacity_(capacity) {}
+    //! \param storage how the inbound stream stores its bytes; ByteStream::Storage::Chunked
+    //!                keeps payloads by reference instead of copying them
+    //! \param memory_budget the most memory that out-of-order payloads may keep alive
+    TCPReceiver(const size_t capacity,
+                const ByteStream::Storage storage = ByteStream::Storage::Ring,
+                const size_t memory_budget = std::numeric_limits<size_t>::max());
+
+    //! Initialize a TCPReceiver from the receiver fields of a TCPConfig
+    explicit TCPReceiver(const TCPConfig &config);
 
     //! \name Accessors to provide feedback to the remote TCPSender
     //!@{
@@ -64,7 +103,18 @@ class TCPReceiver {
     //! the first byte that falls after the window (and will not be
     //! accepted by the receiver) and (b) the sequence number of the
     //! beginning of the window (the ackno).
+    //!
+    //! With a TCPConfig::recv_memory_accountant under pressure, only half of the
+    //! free capacity is offered, and none once the shared budget is exhausted.
+    //! A window already advertised (see advertise_window()) is never shrunk, though.
     size_t window_size() const;
+
+    //! \brief The window size to send to the peer, at most `max_window`, recorded as advertised
+    //!
+    //! The right edge of an advertised window is never taken back, so this is for a window
+    //! that is actually sent. The memory charge is refreshed first, as the reader may have
+    //! freed memory since the last segment arrived.
+    size_t advertise_window(const size_t max_window);
     //!@}
 
     //! \brief number of bytes stored but not yet reassembled
@@ -73,6 +123,18 @@ class TCPReceiver {
     //! \brief handle an inbound segment
     void segment_received(const TCPSegment &seg);
 
+    //! \brief handle a batch of inbound segments, in arrival order, e.g. several datagrams read at once
+    //! \details Equivalent to segment_received() on each, with a single pass to reassemble them.
+    void segments_received(const std::vector<TCPSegment> &segs);
+
+    //! \brief Notifies the TCPReceiver of the passage of time
+    //! \details With TCPConfig::recv_capacity_max above the capacity, this is when the
+    //! capacity is auto-tuned to how fast the reader drains the stream.
+    void tick(const size_t ms_since_last_tick);
+
+    //! \brief The current capacity (grown by auto-tuning)
+    size_t capacity() const { return capacity_; }
+
     //! \name "Output" interface for the reader
     //!@{
     ByteStream &stream_out() { return reassembler_.stream_out(); }
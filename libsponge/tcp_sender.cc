@@ -2,21 +2,41 @@
 
 #include "tcp_config.hh"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <random>
+#include <stdexcept>
 
 // For Lab 3, please replace with a real implementation that passes the
 // automated checks run by `make check_lab3`.
 
 using namespace std;
 
+// Config carrying only the fields that the classic TCPSender constructor takes.
+static TCPConfig sender_config(const size_t capacity,
+                               const uint16_t retx_timeout,
+                               const std::optional<WrappingInt32> fixed_isn) {
+  TCPConfig config;
+  config.send_capacity = capacity;
+  config.rt_timeout = retx_timeout;
+  config.fixed_isn = fixed_isn;
+  return config;
+}
+
 //! \param[in] capacity the capacity of the outgoing byte stream
 //! \param[in] retx_timeout the initial amount of time to wait before retransmitting the oldest outstanding segment
 //! \param[in] fixed_isn the Initial Sequence Number to use, if set (otherwise uses a random ISN)
 TCPSender::TCPSender(const size_t capacity, const uint16_t retx_timeout, const std::optional<WrappingInt32> fixed_isn) :
-  isn_(fixed_isn.value_or(WrappingInt32{random_device()()})),
-  initial_retransmission_timeout_{retx_timeout},
-  stream_(capacity),
+  TCPSender(sender_config(capacity, retx_timeout, fixed_isn)) {}
+
+//! \param[in] config the TCPConfig whose send_capacity, send_storage, rt_timeout and fixed_isn are used,
+//! along with the fields for adaptive RTO, auto-tuning, congestion control and pacing
+//! \throws std::runtime_error if `rto_min` is above `rto_max`
+TCPSender::TCPSender(const TCPConfig &config) :
+  isn_(config.fixed_isn.value_or(WrappingInt32{random_device()()})),
+  initial_retransmission_timeout_{config.rt_timeout},
+  stream_(config.send_capacity, config.send_storage),
   consecutive_retransmissions_(0),
   window_size_(1),
   latest_abs_ackno_(0),
@@ -24,7 +44,121 @@ TCPSender::TCPSender(const size_t capacity, const uint16_t retx_timeout, const s
   timer_starts_(false),
   timer_countdown_(initial_retransmission_timeout_),
   RTO_(initial_retransmission_timeout_),
-  bytes_in_flight_(0) {}
+  bytes_in_flight_(0),
+  time_ms_(0),
+  rtt_timing_(false),
+  rtt_end_seqno_(0),
+  rtt_start_ms_(0),
+  srtt_ms_(0),
+  rttvar_ms_(0),
+  adaptive_rto_(config.adaptive_rto),
+  rto_min_(config.rto_min),
+  rto_max_(config.rto_max),
+  capacity_max_(config.send_capacity_max),
+  stream_filled_(false),
+  space_start_ms_(0),
+  space_start_ackno_(0),
+  congestion_controller_(CongestionController::make(config.congestion_control, TCPConfig::MAX_PAYLOAD_SIZE)),
+  duplicate_acks_(0),
+  in_recovery_(false),
+  fast_recovery_(false),
+  recovery_point_(0),
+  delivered_(0),
+  delivered_time_ms_(0),
+  first_sent_time_ms_(0),
+  app_limited_until_(0),
+  pacing_(config.pacing),
+  pacing_max_burst_(config.pacing_max_burst),
+  pacing_release_ms_(0),
+  previous_tick_ms_(0),
+  pacing_held_(false),
+  pacing_releasing_(false) {
+  if (rto_min_ > rto_max_) {
+    throw runtime_error("TCPSender: rto_min is above rto_max");
+  }
+}
+
+void TCPSender::start_rtt_sample(const TCPSegment &segment) {
+  if (!rtt_timing_) {
+    rtt_timing_ = true;
+    rtt_end_seqno_ = unwrap(segment.header().seqno, isn_, next_seqno_) + segment.length_in_sequence_space();
+    rtt_start_ms_ = time_ms_;
+  }
+}
+
+//! \details RTO = SRTT + max(G, 4 * RTTVAR), within the configured bounds (RFC 6298 section 2).
+void TCPSender::reset_rto() {
+  RTO_ = initial_retransmission_timeout_;
+  if (adaptive_rto_ && srtt_ms_ != 0) {
+    RTO_ = clamp<size_t>(srtt_ms_ + max(CLOCK_GRANULARITY_MS, 4 * rttvar_ms_), rto_min_, rto_max_);
+  }
+}
+
+//! \details Twice the bytes delivered per round trip lets the writer queue the next
+//! round trip's worth while the current one is in flight. A writer that never fills the
+//! stream doesn't need more room, so the capacity grows only after it has, and never shrinks.
+void TCPSender::adjust_capacity() {
+  if (srtt_ms_ == 0 || time_ms_ - space_start_ms_ < srtt_ms_) {
+    return;
+  }
+  const size_t wanted = min(2 * (latest_abs_ackno_ - space_start_ackno_), capacity_max_);
+  if (stream_filled_ && wanted > stream_.capacity()) {
+    stream_.grow_capacity(wanted);
+  }
+  stream_filled_ = false;
+  space_start_ms_ = time_ms_;
+  space_start_ackno_ = latest_abs_ackno_;
+}
+
+uint64_t TCPSender::send_window() const {
+  return congestion_controller_ ? min(window_size_, congestion_controller_->cwnd()) : window_size_;
+}
+
+double TCPSender::pacing_rate() const {
+  if (congestion_controller_ && congestion_controller_->pacing_rate() > 0) {
+    return congestion_controller_->pacing_rate();
+  }
+  if (!pacing_ || srtt_ms_ == 0) {
+    return 0;
+  }
+  const double gain = congestion_controller_ ? congestion_controller_->pacing_gain() : 1;
+  return gain * send_window() / srtt_ms_;
+}
+
+optional<size_t> TCPSender::time_until_send() const {
+  if (!pacing_held_) {
+    return {};
+  }
+  return size_t(max(ceil(pacing_release_ms_ - time_ms_), 1.0));
+}
+
+//! \details Also schedules the next segment's release, if pacing. After an idle spell, up to
+//! pacing_max_burst_ bytes may go at once. When tick() releases held segments, they may also
+//! catch up on whatever came due since the previous tick, as the sender only wakes up on
+//! ticks and acks: this keeps coarse ticks from capping the rate.
+void TCPSender::segment_sent(const TCPSegment &segment) {
+  const size_t length = segment.length_in_sequence_space();
+  if (bytes_in_flight_ == 0) {  // a new flight: measure from here
+    first_sent_time_ms_ = delivered_time_ms_ = time_ms_;
+  }
+  bytes_in_flight_ += length;
+  flying_segments_.push(segment);
+  flying_records_.push({delivered_, delivered_time_ms_, first_sent_time_ms_, time_ms_, app_limited_until_ != 0});
+  segments_out_.push(segment);
+  start_rtt_sample(segment);
+
+  if (congestion_controller_) {
+    congestion_controller_->on_send(length, bytes_in_flight_, time_ms_);
+  }
+  const double rate = pacing_rate();
+  if (rate > 0) {
+    double earliest_ms = time_ms_ - (double(max(pacing_max_burst_, length)) - length) / rate;
+    if (pacing_releasing_) {
+      earliest_ms = min(earliest_ms, double(previous_tick_ms_));
+    }
+    pacing_release_ms_ = max(pacing_release_ms_, earliest_ms) + length / rate;
+  }
+}
 
 /*
  * 1. Reads from its input ByteStream and sends as many bytes as possible in the form of
@@ -48,6 +182,19 @@ TCPSender::TCPSender(const size_t capacity, const uint16_t retx_timeout, const s
  * (3) SYN, FIN
  */
 void TCPSender::fill_window() {
+  if (stream_.remaining_capacity() == 0) {
+    stream_filled_ = true;
+  }
+  if (pacing_release_ms_ > double(time_ms_)) {  // tick() will call back when the next segment is due
+    pacing_held_ = true;
+    return;
+  }
+  // With room in the window but nothing to send, the flight is limited by the writer, so delivery
+  // rates sampled until it has been acknowledged say nothing about the network.
+  if (stream_.buffer_empty() && bytes_in_flight_ < send_window()) {
+    app_limited_until_ = max<uint64_t>(delivered_ + bytes_in_flight_, 1);
+  }
+
   TCPSegment segment;
   segment.header().seqno = next_seqno();
 
@@ -58,24 +205,24 @@ void TCPSender::fill_window() {
   }
 
   // Set size for current transmission.
+  const uint64_t window = send_window();
   size_t size;
   if (window_size_ == 0) {  // if window-size is 0, set it to 1 to keep communication
     size = 1;
-  } else if (window_size_ <= bytes_in_flight_) {  // window's already been full
+  } else if (window <= bytes_in_flight_) {  // window's already been full
     size = 0;
   } else {
-    size = min(TCPConfig::MAX_PAYLOAD_SIZE, window_size_ - bytes_in_flight_);
+    size = min(TCPConfig::MAX_PAYLOAD_SIZE, window - bytes_in_flight_);
   }
 
   // Set payload for current transmission.
-  string content = stream_.read(size);
-  size = min(size, content.length());  // there could be insufficient bytes within ByteStream
-  segment.payload() = Buffer(move(content));
+  segment.payload() = stream_.read_buffer(size);
+  size = segment.payload().size();  // there could be insufficient bytes within ByteStream
   next_seqno_ += size;
 
   // Set FIN if needed.
   // NOTE: set only when window isn't full.
-  if (stream_.eof() && fin_seqno_ == 0 && window_size_ > bytes_in_flight_ + size) {
+  if (stream_.eof() && fin_seqno_ == 0 && window > bytes_in_flight_ + size) {
     segment.header().fin = true;
     fin_seqno_ = next_seqno_++;
   }
@@ -87,9 +234,7 @@ void TCPSender::fill_window() {
   }
   
   // Segment already set, send the segment out.
-  bytes_in_flight_ += segment.length_in_sequence_space();
-  flying_segments_.push(segment);
-  segments_out_.push(segment);
+  segment_sent(segment);
 
   // Start the timer if needed.
   if (!timer_starts_) {
@@ -98,7 +243,7 @@ void TCPSender::fill_window() {
   }
 
   // To fully utilize window, continue packing segments if possible.
-  if (bytes_in_flight_ < window_size_) {
+  if (bytes_in_flight_ < window) {
     fill_window();
   }
 }
@@ -121,35 +266,96 @@ void TCPSender::ack_received(const WrappingInt32 ackno, const uint16_t window_si
   }
 
   // Update window size for future segment sending.
+  const uint64_t previous_window_size = window_size_;
   window_size_ = window_size;
 
   // Check whether the ack has been handled before.
+  // If it repeats the last ack and window with data outstanding, it's a duplicate ack (RFC 5681 section 2).
   if (abs_ack_seqno64 <= latest_abs_ackno_) {
+    if (congestion_controller_ && abs_ack_seqno64 == latest_abs_ackno_ && window_size_ == previous_window_size &&
+        !flying_segments_.empty()) {
+      duplicate_ack_received();
+    }
     return;
   }
+  duplicate_acks_ = 0;
 
   // ACK an unacknowledged segment.
   // (1) Initialize retransmission-related bookkeeping.
   consecutive_retransmissions_ = 0;
-  timer_countdown_ = initial_retransmission_timeout_;
-  RTO_ = initial_retransmission_timeout_;
 
   // (2) Deal with bytes in flight.
   uint64_t acked_bytes = abs_ack_seqno64 - latest_abs_ackno_;
   bytes_in_flight_ -= acked_bytes;
+  delivered_ += acked_bytes;
+  delivered_time_ms_ = time_ms_;
+  optional<DeliveryRecord> acked_record{};  // of the most recently sent segment that was fully acked
   while (!flying_segments_.empty()) {
     TCPSegment& flying_segment = flying_segments_.front();
     uint64_t cur_ack_seqno = unwrap(flying_segment.header().seqno, isn_, next_seqno_);
     latest_abs_ackno_ = abs_ack_seqno64;
     if (cur_ack_seqno + flying_segment.length_in_sequence_space() <= abs_ack_seqno64) {  // the segment is fully acked
       flying_segments_.pop();
+      acked_record = flying_records_.front();
+      flying_records_.pop();
     } else {
       break;
     }
   }
+  if (app_limited_until_ != 0 && delivered_ > app_limited_until_) {
+    app_limited_until_ = 0;
+  }
   if (flying_segments_.empty()) {
     timer_starts_ = false;
   }
+
+  // (3) Sample the round-trip time (alpha = 1/8 and beta = 1/4, as in RFC 6298), and restart
+  // the timer from a fresh RTO.
+  size_t rtt_sample = 0;
+  if (rtt_timing_ && abs_ack_seqno64 >= rtt_end_seqno_) {
+    rtt_sample = max<size_t>(time_ms_ - rtt_start_ms_, 1);
+    if (srtt_ms_ == 0) {
+      srtt_ms_ = rtt_sample;
+      rttvar_ms_ = rtt_sample / 2;
+    } else {
+      rttvar_ms_ = (3 * rttvar_ms_ + max(srtt_ms_, rtt_sample) - min(srtt_ms_, rtt_sample)) / 4;
+      srtt_ms_ = (7 * srtt_ms_ + rtt_sample) / 8;
+    }
+    rtt_timing_ = false;
+  }
+  reset_rto();
+  timer_countdown_ = RTO_;
+
+  // (4) Tell the congestion controller. Until the loss being repaired is fully acked, each
+  // partial ack reveals the next hole, which is retransmitted right away (RFC 6582), whether
+  // the loss was detected by duplicate acks or by the timer.
+  if (congestion_controller_) {
+    CongestionController::Ack ack{acked_bytes, bytes_in_flight_, rtt_sample, time_ms_, fast_recovery_};
+    if (in_recovery_ && abs_ack_seqno64 >= recovery_point_) {
+      ack.recovered = true;
+      in_recovery_ = false;
+      fast_recovery_ = false;
+    } else if (in_recovery_ && !flying_segments_.empty()) {
+      segments_out_.push(flying_segments_.front());
+    }
+
+    // (5) Sample the delivery rate over the flight of the most recently sent segment that was acked,
+    // as the slower of its sending and acknowledgment rates.
+    ack.delivered = delivered_;
+    if (acked_record) {
+      first_sent_time_ms_ = acked_record->sent_time_ms;
+      const size_t send_elapsed = acked_record->sent_time_ms - acked_record->first_sent_time_ms;
+      const size_t ack_elapsed = time_ms_ - acked_record->delivered_time_ms;
+      ack.prior_delivered = acked_record->delivered;
+      ack.delivery_rate = double(delivered_ - acked_record->delivered) / max<size_t>(max(send_elapsed, ack_elapsed), 1);
+      ack.app_limited = acked_record->app_limited;
+    }
+    congestion_controller_->on_ack(ack);
+  }
+
+  if (capacity_max_ > stream_.capacity()) {
+    adjust_capacity();
+  }
 }
 
 //! \param[in] ms_since_last_tick the number of milliseconds since the last call to this method
@@ -159,24 +365,65 @@ void TCPSender::ack_received(const WrappingInt32 ackno, const uint16_t window_si
 // (1) Increment consecutive retransmissions #
 // (2) exponential backoff: double the value of RTO
 // 3. Reset the retransmission timer 
+// 4. Release the segments that pacing held back, if they are due: only now, so that a timer
+// they start counts down a whole RTO from here.
 void TCPSender::tick(const size_t ms_since_last_tick) {
-  if (!timer_starts_) {
-    return;
+  previous_tick_ms_ = time_ms_;
+  time_ms_ += ms_since_last_tick;
+  if (timer_starts_) {
+    timer_countdown_ -= ms_since_last_tick;
+    if (timer_countdown_ <= 0) {
+      retransmit_on_timeout();
+    }
   }
 
-  timer_countdown_ -= ms_since_last_tick;
-  if (timer_countdown_ > 0) {
-    return;
+  if (pacing_held_ && pacing_release_ms_ <= double(time_ms_)) {
+    pacing_held_ = false;
+    pacing_releasing_ = true;
+    fill_window();
+    pacing_releasing_ = false;
   }
+}
 
+void TCPSender::retransmit_on_timeout() {
   segments_out_.push(flying_segments_.front());
+  rtt_timing_ = false;  // an ack could now be for either transmission
   if (window_size_ > 0) {
     ++consecutive_retransmissions_;
-    RTO_ *= 2;
+    RTO_ = adaptive_rto_ ? min(2 * RTO_, rto_max_) : 2 * RTO_;
+    // a timeout with an open window means the network lost the segment, and more than fast recovery can repair:
+    // the window starts over, but the holes up to what has been sent are still repaired as partial acks reveal them
+    if (congestion_controller_) {
+      congestion_controller_->on_rto(bytes_in_flight_, time_ms_);
+      in_recovery_ = true;
+      fast_recovery_ = false;
+      duplicate_acks_ = 0;
+      recovery_point_ = next_seqno_;
+    }
   }
   timer_countdown_ = RTO_;
 }
 
+//! \details Duplicate acks for data sent before the last loss was detected don't signal a new
+//! loss (RFC 6582 section 3.2), so the window is cut at most once per window of data. In fast
+//! recovery, each one means that another segment has left the network (RFC 5681 section 3.2).
+void TCPSender::duplicate_ack_received() {
+  ++duplicate_acks_;
+  if (fast_recovery_) {
+    congestion_controller_->on_duplicate_ack();
+    return;
+  }
+  if (duplicate_acks_ != DUPLICATE_ACK_THRESHOLD || latest_abs_ackno_ < recovery_point_) {
+    return;
+  }
+  segments_out_.push(flying_segments_.front());
+  rtt_timing_ = false;
+  in_recovery_ = true;
+  fast_recovery_ = true;
+  recovery_point_ = next_seqno_;
+  congestion_controller_->on_loss(bytes_in_flight_, time_ms_);
+}
+
 // For TCPConnection to send an empty ACK segment.
 void TCPSender::send_empty_segment() {
   TCPSegment segment;
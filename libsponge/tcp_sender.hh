@@ -2,11 +2,15 @@
 #define SPONGE_LIBSPONGE_TCP_SENDER_HH
 
 #include "byte_stream.hh"
+#include "congestion_controller.hh"
 #include "tcp_config.hh"
 #include "tcp_segment.hh"
 #include "wrapping_integers.hh"
 
 #include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <queue>
 
 //! Accepts a ByteStream, divides it up into segments and sends the
@@ -60,12 +64,94 @@ class TCPSender {
     // Note: flying_segments_ doesn't store retransmitted segments.
     std::queue<TCPSegment> flying_segments_{};
 
+    // Time elapsed, as told by tick().
+    size_t time_ms_;
+
+    // Round-trip time sampling: one segment at a time is timed, and never a retransmitted one (Karn).
+    bool rtt_timing_;         // whether a segment is being timed
+    uint64_t rtt_end_seqno_;  // the ackno that acknowledges the timed segment
+    size_t rtt_start_ms_;     // when the timed segment was sent
+    size_t srtt_ms_;          // smoothed round-trip time, or 0 before the first sample
+    size_t rttvar_ms_;        // round-trip time variation
+
+    // Adaptive retransmission timeout (RFC 6298), with TCPConfig::adaptive_rto.
+    static constexpr size_t CLOCK_GRANULARITY_MS = 1;  // G: tick() counts whole milliseconds
+    bool adaptive_rto_;
+    unsigned int rto_min_;
+    unsigned int rto_max_;
+
+    // Set RTO_ afresh, undoing any backoff: from the round-trip estimate with adaptive RTO,
+    // otherwise (or before the first sample) to the initial timeout.
+    void reset_rto();
+
+    // Send buffer auto-tuning (like Linux's tcp_sndbuf_expand).
+    size_t capacity_max_;          // the stream's capacity never grows beyond this
+    bool stream_filled_;           // whether the writer has filled the stream since the last adjustment
+    size_t space_start_ms_;        // when the current measurement of the delivery rate started
+    uint64_t space_start_ackno_;   // latest_abs_ackno_ then
+
+    // Time the segment just sent, if no other segment is being timed.
+    void start_rtt_sample(const TCPSegment &segment);
+
+    // Once per round trip, grow the stream's capacity to twice the bytes acknowledged in it,
+    // if the writer was held back by a full stream.
+    void adjust_capacity();
+
+    // Congestion control (see TCPConfig::congestion_control), or nullptr to be limited by the receiver's window alone.
+    std::unique_ptr<CongestionController> congestion_controller_;
+
+    // Loss detection by duplicate acks (RFC 5681 fast retransmit, RFC 6582 NewReno fast recovery);
+    // only with congestion control.
+    static constexpr unsigned DUPLICATE_ACK_THRESHOLD = 3;
+    unsigned duplicate_acks_;    // consecutive duplicate acks
+    bool in_recovery_;           // whether a loss is being repaired, until recovery_point_ is acked
+    bool fast_recovery_;         // whether that loss was detected by duplicate acks, rather than the timer
+    uint64_t recovery_point_;    // next_seqno_ when the last loss was detected (or the timer expired)
+
+    // Delivery-rate estimation (draft-cheng-iccrg-delivery-rate-estimation), for congestion control.
+    struct DeliveryRecord {
+      uint64_t delivered;          // delivered_ when the segment was sent
+      size_t delivered_time_ms;    // delivered_time_ms_ then
+      size_t first_sent_time_ms;   // first_sent_time_ms_ then
+      size_t sent_time_ms;         // when the segment was sent
+      bool app_limited;            // whether the writer, rather than the network, was limiting the sender
+    };
+    std::queue<DeliveryRecord> flying_records_{};  // one per flying segment
+    uint64_t delivered_;           // bytes (in sequence space) acknowledged so far
+    size_t delivered_time_ms_;     // when delivered_ last grew
+    size_t first_sent_time_ms_;    // when the segment most recently acknowledged was sent
+    uint64_t app_limited_until_;   // delivered_ at which the sender stops being app-limited, or 0
+
+    // Pacing: when the next segment may be sent (see pacing_rate()).
+    bool pacing_;                  // whether to pace without a controller's pacing rate (TCPConfig::pacing)
+    size_t pacing_max_burst_;      // most bytes sent back to back after an idle spell
+    double pacing_release_ms_;     // when the next segment may be sent, in ms on the time_ms_ clock, with fractions
+    size_t previous_tick_ms_;      // time_ms_ at the previous tick
+    bool pacing_held_;             // whether fill_window() held segments back, for tick() to release
+    bool pacing_releasing_;        // whether tick() is releasing them
+
+    // The receiver's window, further limited by the congestion window, if any.
+    uint64_t send_window() const;
+
+    // Record a segment as it goes in flight.
+    void segment_sent(const TCPSegment &segment);
+
+    // The retransmission timer expired: retransmit the oldest segment, back off and restart the timer.
+    void retransmit_on_timeout();
+
+    // Count a duplicate ack, and retransmit the oldest segment on the third in a row;
+    // in fast recovery, tell the congestion controller instead.
+    void duplicate_ack_received();
+
   public:
     //! Initialize a TCPSender
     TCPSender(const size_t capacity = TCPConfig::DEFAULT_CAPACITY,
               const uint16_t retx_timeout = TCPConfig::TIMEOUT_DFLT,
               const std::optional<WrappingInt32> fixed_isn = {});
 
+    //! Initialize a TCPSender from the sender fields of a TCPConfig, whose `rto_min` may not be above `rto_max`
+    explicit TCPSender(const TCPConfig &config);
+
     //! \name "Input" interface for the writer
     //!@{
     ByteStream &stream_in() { return stream_; }
@@ -85,9 +171,16 @@ class TCPSender {
     void fill_window();
 
     //! \brief Notifies the TCPSender of the passage of time
+    //! \details With TCPConfig::send_capacity_max above the capacity, the capacity of stream_in()
+    //! is also auto-tuned, as acknowledgments arrive, to the bytes delivered per round trip.
+    //! Segments that pacing held back are sent once they are due.
     void tick(const size_t ms_since_last_tick);
     //!@}
 
+    //! \brief Milliseconds until tick() will send segments that pacing holds back, if it holds any
+    //! \details An event loop can wait this long, rather than a whole tick, to keep the pace.
+    std::optional<size_t> time_until_send() const;
+
     //! \name Accessors
     //!@{
 
@@ -99,6 +192,27 @@ class TCPSender {
     //! \brief Number of consecutive retransmissions that have occurred in a row
     unsigned int consecutive_retransmissions() const { return consecutive_retransmissions_; }
 
+    //! \brief The current retransmission timeout, in milliseconds, backoff included
+    unsigned int retransmission_timeout() const { return RTO_; }
+
+    //! \brief The smoothed round-trip time, in milliseconds, or 0 before the first sample
+    //! \details Sampled one segment at a time, and never from a retransmitted one (Karn's algorithm).
+    size_t smoothed_rtt() const { return srtt_ms_; }
+
+    //! \brief The round-trip time variation, in milliseconds (RTTVAR in RFC 6298)
+    size_t rtt_variation() const { return rttvar_ms_; }
+
+    //! \brief The rate, in bytes per millisecond, at which new segments are spaced out, or 0 if they aren't
+    //! \details The congestion control's own CongestionController::pacing_rate(), if it has one.
+    //! Otherwise, with TCPConfig::pacing, its CongestionController::pacing_gain() (1 without
+    //! congestion control) times the window per smoothed round trip.
+    double pacing_rate() const;
+
+    //! \brief The congestion window, or the largest possible value without congestion control
+    uint64_t congestion_window() const {
+        return congestion_controller_ ? congestion_controller_->cwnd() : std::numeric_limits<uint64_t>::max();
+    }
+
     //! \brief TCPSegments that the TCPSender has enqueued for transmission.
     //! \note These must be dequeued and sent by the TCPConnection,
     //! which will need to fill in the fields that are set by the TCPReceiver
@@ -7,7 +7,17 @@ void Buffer::remove_prefix(const size_t n) {
         throw out_of_range("Buffer::remove_prefix");
     }
     _starting_offset += n;
-    if (_storage and _starting_offset == _storage->size()) {
+    if (_storage and _starting_offset == _ending_offset) {
+        _storage.reset();
+    }
+}
+
+void Buffer::remove_suffix(const size_t n) {
+    if (n > str().size()) {
+        throw out_of_range("Buffer::remove_suffix");
+    }
+    _ending_offset -= n;
+    if (_storage and _starting_offset == _ending_offset) {
         _storage.reset();
     }
 }
@@ -70,6 +80,8 @@ BufferViewList::BufferViewList(const BufferList &buffers) {
     }
 }
 
+void BufferViewList::append(std::string_view str) { _views.push_back(str); }
+
 void BufferViewList::remove_prefix(size_t n) {
     while (n > 0) {
         if (_views.empty()) {
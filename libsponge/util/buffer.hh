@@ -15,12 +15,14 @@ class Buffer {
   private:
     std::shared_ptr<std::string> _storage{};
     size_t _starting_offset{};
+    size_t _ending_offset{};
 
   public:
     Buffer() = default;
 
     //! \brief Construct by taking ownership of a string
-    Buffer(std::string &&str) noexcept : _storage(std::make_shared<std::string>(std::move(str))) {}
+    Buffer(std::string &&str) noexcept
+        : _storage(std::make_shared<std::string>(std::move(str))), _ending_offset(_storage->size()) {}
 
     //! \name Expose contents as a std::string_view
     //!@{
@@ -28,7 +30,7 @@ class Buffer {
         if (not _storage) {
             return {};
         }
-        return {_storage->data() + _starting_offset, _storage->size() - _starting_offset};
+        return {_storage->data() + _starting_offset, _ending_offset - _starting_offset};
     }
 
     operator std::string_view() const { return str(); }
@@ -43,9 +45,16 @@ class Buffer {
     //! \brief Make a copy to a new std::string
     std::string copy() const { return std::string(str()); }
 
+    //! \brief Bytes allocated for the whole string this Buffer shares, however little of it the Buffer still holds
+    size_t footprint() const { return _storage ? _storage->capacity() : 0; }
+
     //! \brief Discard the first `n` bytes of the string (does not require a copy or move)
     //! \note Doesn't free any memory until the whole string has been discarded in all copies of the Buffer.
     void remove_prefix(const size_t n);
+
+    //! \brief Discard the last `n` bytes of the string (does not require a copy or move)
+    //! \note Lets several Buffers share disjoint slices of one string.
+    void remove_suffix(const size_t n);
 };
 
 //! \brief A reference-counted discontiguous string that can discard bytes from the front
@@ -101,6 +110,8 @@ class BufferViewList {
     //! \name Constructors
     //!@{
 
+    BufferViewList() = default;
+
     //! \brief Construct from a std::string
     BufferViewList(const std::string &str) : BufferViewList(std::string_view(str)) {}
 
@@ -114,6 +125,9 @@ class BufferViewList {
     BufferViewList(std::string_view str) { _views.push_back({const_cast<char *>(str.data()), str.size()}); }
     //!@}
 
+    //! \brief Append a std::string_view to the end of the list
+    void append(std::string_view str);
+
     //! \brief Discard the first `n` bytes of the string (does not require a copy or move)
     void remove_prefix(size_t n);
 
@@ -3,6 +3,7 @@
 #include "util.hh"
 
 #include <algorithm>
+#include <climits>
 #include <fcntl.h>
 #include <iostream>
 #include <stdexcept>
@@ -47,7 +48,6 @@ FileDescriptor FileDescriptor::duplicate() const { return FileDescriptor(_intern
 //! \param[in] limit is the maximum number of bytes to read; fewer bytes may be returned
 //! \param[out] str is the string to be read
 void FileDescriptor::read(std::string &str, const size_t limit) {
-    constexpr size_t BUFFER_SIZE = 1024 * 1024;  // maximum size of a read
     const size_t size_to_read = min(BUFFER_SIZE, limit);
     str.resize(size_to_read);
 
@@ -73,11 +73,35 @@ string FileDescriptor::read(const size_t limit) {
     return ret;
 }
 
+//! \param[in] buffers are the regions to fill; fewer bytes than their total size may be read
+//! \returns the number of bytes read
+size_t FileDescriptor::read(const vector<iovec> &buffers) {
+    size_t size_to_read = 0;
+    for (const auto &buffer : buffers) {
+        size_to_read += buffer.iov_len;
+    }
+
+    const ssize_t bytes_read = SystemCall("readv", ::readv(fd_num(), buffers.data(), buffers.size()));
+    if (size_to_read > 0 && bytes_read == 0) {
+        _internal_fd->_eof = true;
+    }
+    if (bytes_read > static_cast<ssize_t>(size_to_read)) {
+        throw runtime_error("readv() read more than requested");
+    }
+
+    register_read();
+
+    return bytes_read;
+}
+
 size_t FileDescriptor::write(BufferViewList buffer, const bool write_all) {
     size_t total_bytes_written = 0;
 
     do {
         auto iovecs = buffer.as_iovecs();
+        if (iovecs.size() > IOV_MAX) {
+            iovecs.resize(IOV_MAX);  // writev() rejects more with EINVAL; the rest goes in the next call
+        }
 
         const ssize_t bytes_written = SystemCall("writev", ::writev(fd_num(), iovecs.data(), iovecs.size()));
         if (bytes_written == 0 and buffer.size() != 0) {
@@ -7,6 +7,8 @@
 #include <cstddef>
 #include <limits>
 #include <memory>
+#include <sys/uio.h>
+#include <vector>
 
 //! A reference-counted handle to a file descriptor
 class FileDescriptor {
@@ -49,6 +51,8 @@ class FileDescriptor {
     void register_write() { ++_internal_fd->_write_count; }  //!< increment write count
 
   public:
+    static constexpr size_t BUFFER_SIZE = 1024 * 1024;  //!< maximum size of a read into a string
+
     //! Construct from a file descriptor number returned by the kernel
     explicit FileDescriptor(const int fd);
 
@@ -61,6 +65,10 @@ class FileDescriptor {
     //! Read up to `limit` bytes into `str` (caller can allocate storage)
     void read(std::string &str, const size_t limit = std::numeric_limits<size_t>::max());
 
+    //! Read into caller-provided memory regions, in order, with a single [readv(2)](\ref man2::readv)
+    //! \returns the number of bytes read
+    size_t read(const std::vector<iovec> &buffers);
+
     //! Write a string, possibly blocking until all is written
     size_t write(const char *str, const bool write_all = true) { return write(BufferViewList(str), write_all); }
 
@@ -68,6 +76,7 @@ class FileDescriptor {
     size_t write(const std::string &str, const bool write_all = true) { return write(BufferViewList(str), write_all); }
 
     //! Write a buffer (or list of buffers), possibly blocking until all is written
+    //! \note Each [writev(2)](\ref man2::writev) takes at most IOV_MAX of the buffers
     size_t write(BufferViewList buffer, const bool write_all = true);
 
     //! Close the underlying file descriptor
@@ -0,0 +1,93 @@
+#include "mirrored_buffer.hh"
+
+#include "util.hh"
+
+#include <cerrno>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace std;
+
+//! \param[in] min_size is the smallest acceptable size() of the ring
+//! \param[in] huge_pages asks for huge pages, falling back to normal pages if none are available
+MirroredBuffer::MirroredBuffer(const size_t min_size, const bool huge_pages) {
+    if (min_size == 0) {
+        throw runtime_error("MirroredBuffer: size must be positive");
+    }
+    if (huge_pages && map(min_size, HUGE_PAGE_SIZE, MFD_HUGETLB)) {
+        _huge_pages = true;
+        return;
+    }
+    const long page_size = SystemCall("sysconf", ::sysconf(_SC_PAGESIZE));
+    if (not map(min_size, page_size, 0)) {
+        throw unix_error("mmap");
+    }
+}
+
+//! \details Reserves 2 * size bytes of address space, then maps the same memfd over
+//! both halves. The memfd is closed once mapped; the mappings keep it alive.
+//! Only a failure that huge pages can cause (no memfd support, no free huge pages)
+//! is reported by returning `false`; any other failure throws.
+bool MirroredBuffer::map(const size_t min_size, const size_t page_size, const unsigned memfd_flags) {
+    const size_t size = (min_size + page_size - 1) / page_size * page_size;
+
+    const int fd = ::memfd_create("sponge-ring", memfd_flags);
+    if (fd < 0) {
+        if (memfd_flags != 0 && (errno == EINVAL || errno == ENOENT)) {
+            return false;
+        }
+        throw unix_error("memfd_create");
+    }
+
+    try {
+        SystemCall("ftruncate", ::ftruncate(fd, size));
+
+        void *const region = ::mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            throw unix_error("mmap");
+        }
+        char *const first = static_cast<char *>(region);
+        for (char *const half : {first, first + size}) {
+            if (::mmap(half, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                const int mmap_errno = errno;
+                ::munmap(region, 2 * size);
+                if (memfd_flags != 0 && mmap_errno == ENOMEM) {
+                    ::close(fd);
+                    return false;
+                }
+                throw unix_error("mmap", mmap_errno);
+            }
+        }
+        _data = first;
+        _size = size;
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+
+    SystemCall("close", ::close(fd));
+    return true;
+}
+
+void MirroredBuffer::unmap() {
+    if (_data) {
+        ::munmap(_data, 2 * _size);
+        _data = nullptr;
+        _size = 0;
+    }
+}
+
+MirroredBuffer::MirroredBuffer(MirroredBuffer &&other) noexcept
+    : _data(exchange(other._data, nullptr)), _size(exchange(other._size, 0)), _huge_pages(other._huge_pages) {}
+
+MirroredBuffer &MirroredBuffer::operator=(MirroredBuffer &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        _data = exchange(other._data, nullptr);
+        _size = exchange(other._size, 0);
+        _huge_pages = other._huge_pages;
+    }
+    return *this;
+}
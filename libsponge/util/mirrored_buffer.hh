@@ -0,0 +1,55 @@
+#ifndef SPONGE_LIBSPONGE_MIRRORED_BUFFER_HH
+#define SPONGE_LIBSPONGE_MIRRORED_BUFFER_HH
+
+#include <cstddef>
+
+//! \brief A ring of memory mapped twice, back to back, in virtual memory.
+
+//! The byte at `data()[i + size()]` is the same physical byte as `data()[i]`,
+//! so any run of up to size() bytes starting inside the ring is contiguous,
+//! even when it wraps around the end.
+class MirroredBuffer {
+  private:
+    char *_data = nullptr;  //!< Start of the first of the two mappings
+    size_t _size = 0;       //!< Size of one mapping (a multiple of the page size used)
+    bool _huge_pages = false;  //!< Whether the ring is backed by huge pages
+
+    //! Map the ring using pages of `page_size` bytes, with `memfd_flags` passed to [memfd_create(2)](\ref man2::memfd_create)
+    //! \returns `false` if the mapping failed for lack of suitable pages
+    bool map(const size_t min_size, const size_t page_size, const unsigned memfd_flags);
+
+    //! Unmap both views of the ring
+    void unmap();
+
+  public:
+    //! Size of the huge pages tried when `huge_pages` is requested
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    //! Map a ring of at least `min_size` bytes, rounded up to the page size
+    //! \param[in] min_size is the smallest acceptable size() of the ring
+    //! \param[in] huge_pages asks for huge pages, falling back to normal pages if none are available
+    explicit MirroredBuffer(const size_t min_size, const bool huge_pages = false);
+
+    //! Unmap the ring
+    ~MirroredBuffer() { unmap(); }
+
+    //! \name
+    //! A MirroredBuffer cannot be copied, but can be moved
+
+    //!@{
+    MirroredBuffer(const MirroredBuffer &other) = delete;
+    MirroredBuffer &operator=(const MirroredBuffer &other) = delete;
+    MirroredBuffer(MirroredBuffer &&other) noexcept;
+    MirroredBuffer &operator=(MirroredBuffer &&other) noexcept;
+    //!@}
+
+    //! \name Accessors
+    //!@{
+    char *data() { return _data; }
+    const char *data() const { return _data; }
+    size_t size() const { return _size; }           //!< Size of the ring (half of the mapped region)
+    bool huge_pages() const { return _huge_pages; }  //!< Whether the ring is backed by huge pages
+    //!@}
+};
+
+#endif  // SPONGE_LIBSPONGE_MIRRORED_BUFFER_HH
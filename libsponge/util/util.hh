@@ -48,6 +48,9 @@ int SystemCall(const std::string &attempt, const int return_value, const int err
 //! Seed a fast random generator
 std::mt19937 get_random_generator();
 
+//! Round up to a power of two, e.g. so that ring indices can be masked rather than divided.
+size_t round_up_pow2(const size_t n);
+
 //! Get the time in milliseconds since the program began.
 uint64_t timestamp_ms();
 
@@ -0,0 +1,96 @@
+#ifndef SPONGE_BOTTLENECK_LINK_HH
+#define SPONGE_BOTTLENECK_LINK_HH
+
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct LinkStats {
+    std::vector<size_t> delivered_late{};  // bytes delivered for each flow over the second half of the run
+    size_t max_queue_late = 0;             // deepest queue at the bottleneck over the second half of the run
+};
+
+// Senders sharing a bottleneck link, simulated one millisecond at a time, with acks returning after the round trip.
+class BottleneckLink {
+    size_t _bandwidth;      // bytes per millisecond through the bottleneck
+    size_t _one_way_delay;  // milliseconds
+    uint16_t _window;       // the receivers' window
+    size_t _send_capacity;  // bytes each sender has to send
+
+  public:
+    BottleneckLink(const size_t bandwidth,
+                   const size_t one_way_delay,
+                   const uint16_t window,
+                   const size_t send_capacity)
+        : _bandwidth(bandwidth), _one_way_delay(one_way_delay), _window(window), _send_capacity(send_capacity) {}
+
+    // Run one sender per algorithm through the link for `duration` milliseconds.
+    LinkStats run(const std::vector<TCPConfig::CongestionControl> &algorithms, const size_t duration) const {
+        std::vector<std::unique_ptr<TCPSender>> senders;
+        for (const auto algorithm : algorithms) {
+            TCPConfig config;
+            config.send_capacity = _send_capacity;
+            config.fixed_isn = WrappingInt32{0};
+            config.congestion_control = algorithm;
+            senders.push_back(std::make_unique<TCPSender>(config));
+            senders.back()->stream_in().write(std::string(config.send_capacity, 'x'));
+        }
+
+        std::deque<std::tuple<size_t, uint64_t, size_t>> queue;  // (flow, end seqno, length) of the queued segments
+        std::deque<std::tuple<size_t, size_t, uint64_t>> acks;   // (arrival time, flow, ackno)
+        size_t queued_bytes = 0;
+        size_t credit = 0;
+        LinkStats stats;
+        stats.delivered_late.resize(senders.size());
+
+        for (size_t now = 0; now < duration; now++) {
+            while (not acks.empty() and std::get<0>(acks.front()) <= now) {
+                const auto [arrival, flow, ackno] = acks.front();
+                senders[flow]->ack_received(WrappingInt32{uint32_t(ackno)}, _window);
+                acks.pop_front();
+            }
+            for (size_t flow = 0; flow < senders.size(); flow++) {
+                TCPSender &sender = *senders[flow];
+                sender.fill_window();
+                for (; not sender.segments_out().empty(); sender.segments_out().pop()) {
+                    const TCPSegment &seg = sender.segments_out().front();
+                    const size_t length = seg.length_in_sequence_space();
+                    queue.emplace_back(flow, seg.header().seqno.raw_value() + length, length);
+                    queued_bytes += length;
+                }
+            }
+            if (now >= duration / 2) {
+                stats.max_queue_late = std::max(stats.max_queue_late, queued_bytes);
+            }
+
+            credit += _bandwidth;
+            while (not queue.empty() and std::get<2>(queue.front()) <= credit) {
+                const auto [flow, end, length] = queue.front();
+                credit -= length;
+                queued_bytes -= length;
+                if (now >= duration / 2) {
+                    stats.delivered_late[flow] += length;
+                }
+                acks.emplace_back(now + 2 * _one_way_delay, flow, end);
+                queue.pop_front();
+            }
+            if (queue.empty()) {
+                credit = 0;
+            }
+            for (auto &sender : senders) {
+                sender->tick(1);
+            }
+        }
+        return stats;
+    }
+};
+
+#endif  // SPONGE_BOTTLENECK_LINK_HH
@@ -0,0 +1,70 @@
+#include "byte_stream.hh"
+#include "byte_stream_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        constexpr auto chunked = ByteStream::Storage::Chunked;
+
+        {
+            ByteStreamTestHarness test{"chunked-write-pop-across-chunks", 15, chunked};
+
+            test.execute(Write{"cat"});
+            test.execute(Write{"tac"});
+            test.execute(Write{"dog"});
+
+            test.execute(BytesWritten{9});
+            test.execute(RemainingCapacity{6});
+            test.execute(BufferSize{9});
+            test.execute(Peek{"cattacdog"});
+            test.execute(PeekView{"cattacd", 3});
+
+            test.execute(Pop{4});
+
+            test.execute(BytesRead{4});
+            test.execute(RemainingCapacity{10});
+            test.execute(Peek{"acdog"});
+            test.execute(PeekView{"acdog", 2});
+
+            test.execute(ReadBuffer{"a"});
+            test.execute(ReadBuffer{"cdo"});
+            test.execute(ReadBuffer{"g"});
+
+            test.execute(BufferEmpty{true});
+            test.execute(BytesRead{9});
+            test.execute(RemainingCapacity{15});
+        }
+
+        {
+            ByteStreamTestHarness test{"chunked-overwrite", 5, chunked};
+
+            test.execute(Write{"abc"});
+            test.execute(Write{"defgh"}.with_bytes_written(2));
+            test.execute(Write{"ijk"}.with_bytes_written(0));
+
+            test.execute(BytesWritten{5});
+            test.execute(RemainingCapacity{0});
+            test.execute(Peek{"abcde"});
+
+            test.execute(Pop{3});
+            test.execute(Write{"xyz"});
+            test.execute(EndInput{});
+
+            test.execute(Peek{"dexyz"});
+            test.execute(ReadBuffer{"dexyz"});
+
+            test.execute(Eof{true});
+            test.execute(BytesRead{8});
+            test.execute(BytesWritten{8});
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
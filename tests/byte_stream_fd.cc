@@ -0,0 +1,96 @@
+#include "byte_stream.hh"
+#include "socket.hh"
+#include "test_should_be.hh"
+#include "util.hh"
+
+#include <array>
+#include <climits>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+
+using namespace std;
+
+static pair<LocalStreamSocket, LocalStreamSocket> make_socket_pair() {
+    array<int, 2> fds{};
+    SystemCall("socketpair", ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()));
+    return {LocalStreamSocket(FileDescriptor(fds[0])), LocalStreamSocket(FileDescriptor(fds[1]))};
+}
+
+static void expect_bytes(const string &actual, const string &expected) {
+    if (actual != expected) {
+        throw runtime_error("expected \"" + expected + "\" but got \"" + actual + "\"");
+    }
+}
+
+static void check_round_trip(const ByteStream::Storage storage) {
+    auto [a, b] = make_socket_pair();
+    ByteStream stream{8, storage};
+
+    // wrap the ring around before reading from the fd
+    test_should_be(stream.write("abcdef"), size_t(6));
+    stream.pop_output(5);
+
+    a.write("0123456789");
+    test_should_be(stream.read_from(b), size_t(7));
+    test_should_be(stream.buffer_size(), size_t(8));
+    test_should_be(stream.remaining_capacity(), size_t(0));
+    test_should_be(stream.bytes_written(), size_t(13));
+    expect_bytes(stream.peek_output(8), "f0123456");
+
+    test_should_be(stream.write_to(b, 3), size_t(3));
+    test_should_be(stream.bytes_read(), size_t(8));
+    expect_bytes(a.read(), "f01");
+
+    test_should_be(stream.read_from(b, 2), size_t(2));
+    test_should_be(stream.write_to(b), size_t(7));
+    expect_bytes(a.read(), "2345678");
+    test_should_be(stream.buffer_empty(), true);
+
+    a.shutdown(SHUT_WR);
+    test_should_be(stream.read_from(b), size_t(1));
+    test_should_be(stream.read_from(b), size_t(0));
+    test_should_be(b.eof(), true);
+    expect_bytes(stream.read(8), "9");
+}
+
+// more chunks than one writev() takes, and a prepare() much larger than a read returns
+static void check_many_chunks() {
+    auto [a, b] = make_socket_pair();
+    ByteStream stream{4 * FileDescriptor::BUFFER_SIZE, ByteStream::Storage::Chunked};
+
+    const size_t chunks = 2 * IOV_MAX + 1;
+    for (size_t i = 0; i < chunks; i++) {
+        stream.write(string(1, char('a' + i % 26)));
+    }
+    size_t written = 0;
+    while (not stream.buffer_empty()) {
+        written += stream.write_to(b);
+    }
+    test_should_be(written, chunks);
+    string received;
+    while (received.size() < chunks) {
+        received += a.read();
+    }
+    test_should_be(received.size(), chunks);
+    expect_bytes(received.substr(0, 3), "abc");
+
+    test_should_be(stream.prepare(stream.remaining_capacity()).front().iov_len, FileDescriptor::BUFFER_SIZE);
+    test_should_be(stream.commit(0), size_t(0));
+}
+
+int main() {
+    try {
+        check_round_trip(ByteStream::Storage::Ring);
+        check_round_trip(ByteStream::Storage::Chunked);
+        check_round_trip(ByteStream::Storage::Mirrored);
+        check_many_chunks();
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,59 @@
+#include "byte_stream.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+static void expect_bytes(const string &actual, const string &expected) {
+    if (actual != expected) {
+        throw runtime_error("expected \"" + expected + "\" but got \"" + actual + "\"");
+    }
+}
+
+static void check_find(const ByteStream::Storage storage) {
+    ByteStream stream{32, storage};
+
+    // wrap the ring around (or split into chunks) in the middle of "\r\n"
+    stream.write(string(17, '-'));
+    stream.pop_output(16);
+    stream.write("GET / HTTP/1.1\r");
+    stream.pop_output(1);
+    stream.write("\nHost");
+
+    test_should_be(stream.find('G'), size_t(0));
+    test_should_be(stream.find('/'), size_t(4));
+    test_should_be(stream.find('/', 5), size_t(10));
+    test_should_be(stream.find('\n'), size_t(15));
+    test_should_be(stream.find('z'), ByteStream::npos);
+    test_should_be(stream.find('G', 20), ByteStream::npos);
+
+    test_should_be(stream.find("HTTP"), size_t(6));
+    test_should_be(stream.find("\r\n"), size_t(14));
+    test_should_be(stream.find("1\r\nHo"), size_t(13));
+    test_should_be(stream.find("\r\nHost!"), ByteStream::npos);
+    test_should_be(stream.find("\r\n", 15), ByteStream::npos);
+    test_should_be(stream.find(""), size_t(0));
+
+    expect_bytes(stream.read_until("\r\n").copy(), "GET / HTTP/1.1\r\n");
+    test_should_be(stream.read_until("\r\n").size(), size_t(0));
+    test_should_be(stream.buffer_size(), size_t(4));
+    expect_bytes(stream.read_until("s").copy(), "Hos");
+    test_should_be(stream.bytes_read(), size_t(36));
+}
+
+int main() {
+    try {
+        check_find(ByteStream::Storage::Ring);
+        check_find(ByteStream::Storage::Chunked);
+        check_find(ByteStream::Storage::Mirrored);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
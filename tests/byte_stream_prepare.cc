@@ -0,0 +1,146 @@
+#include "byte_stream.hh"
+#include "test_should_be.hh"
+
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void expect_bytes(const string &actual, const string &expected) {
+    if (actual != expected) {
+        throw runtime_error("expected \"" + expected + "\" but got \"" + actual + "\"");
+    }
+}
+
+// copy `data` into the prepared regions, in order
+static void fill(const vector<iovec> &regions, const string &data) {
+    size_t done = 0;
+    for (const iovec &region : regions) {
+        size_t len = min(region.iov_len, data.size() - done);
+        memcpy(region.iov_base, data.data() + done, len);
+        done += len;
+    }
+}
+
+static size_t total_size(const vector<iovec> &regions) {
+    size_t total = 0;
+    for (const iovec &region : regions) {
+        total += region.iov_len;
+    }
+    return total;
+}
+
+static void check_prepare_commit(const ByteStream::Storage storage) {
+    ByteStream stream{8, storage};
+
+    // wrap the ring around before preparing
+    test_should_be(stream.write("abcdef"), size_t(6));
+    stream.pop_output(5);
+
+    const vector<iovec> regions = stream.prepare(100);
+    test_should_be(total_size(regions), size_t(7));
+    fill(regions, "0123456");
+    test_should_be(stream.buffer_size(), size_t(1));
+
+    // only the committed prefix is published
+    test_should_be(stream.commit(4), size_t(4));
+    test_should_be(stream.buffer_size(), size_t(5));
+    test_should_be(stream.remaining_capacity(), size_t(3));
+    test_should_be(stream.bytes_written(), size_t(10));
+    expect_bytes(stream.read(8), "f0123");
+
+    // a commit can't publish more than was prepared
+    fill(stream.prepare(2), "xy");
+    test_should_be(stream.commit(5), size_t(2));
+    test_should_be(stream.commit(5), size_t(0));
+    expect_bytes(stream.read(8), "xy");
+    test_should_be(stream.bytes_written(), size_t(12));
+    test_should_be(stream.bytes_read(), size_t(12));
+}
+
+static void check_write_at(const ByteStream::Storage storage) {
+    ByteStream stream{16384, storage};
+
+    test_should_be(stream.write("abc"), size_t(3));
+    test_should_be(stream.write_at(2, "ef"), size_t(2));
+    test_should_be(stream.write_at(9000, "zz"), size_t(2));  // grows the ring past the staged bytes
+    test_should_be(stream.write_at(16381, "yyyy"), size_t(0));
+    test_should_be(stream.buffer_size(), size_t(3));
+
+    // staged bytes survive the stream becoming empty
+    stream.pop_output(3);
+    test_should_be(stream.write_at(0, "cd"), size_t(2));
+    test_should_be(stream.commit(4), size_t(4));
+    expect_bytes(stream.read(8), "cdef");
+
+    // write() fills up to the staged bytes, then commit() publishes them in place
+    test_should_be(stream.write(string(8996, 'x')), size_t(8996));
+    test_should_be(stream.commit(100), size_t(2));
+    test_should_be(stream.bytes_written(), size_t(9005));
+    expect_bytes(stream.peek_output(8998).substr(8994), "xxzz");
+}
+
+static void check_grow_capacity(const ByteStream::Storage storage) {
+    ByteStream stream{4096, storage};
+
+    // readable bytes wrap around the end of the ring, with staged bytes after them
+    test_should_be(stream.write(string(4090, 'x')), size_t(4090));
+    stream.pop_output(4088);
+    test_should_be(stream.write("abcdef"), size_t(6));
+    test_should_be(stream.write_at(0, "zz"), size_t(2));
+
+    stream.grow_capacity(10000);
+    stream.grow_capacity(100);
+    test_should_be(stream.capacity(), size_t(10000));
+    test_should_be(stream.commit(2), size_t(2));
+    expect_bytes(stream.peek_output(10), "xxabcdefzz");
+    test_should_be(stream.write(string(20000, 'y')), size_t(9990));
+    expect_bytes(stream.read(12), "xxabcdefzzyy");
+}
+
+static void check_ring_reuse() {
+    ByteStream stream{65536};
+    test_should_be(stream.allocated_ring_size(), size_t(0));
+
+    // a drained ring is kept for the next writes...
+    test_should_be(stream.write(string(5000, 'x')), size_t(5000));
+    test_should_be(stream.allocated_ring_size(), size_t(8192));
+    stream.pop_output(5000);
+    test_should_be(stream.allocated_ring_size(), size_t(8192));
+    test_should_be(stream.write("abc"), size_t(3));
+    test_should_be(stream.allocated_ring_size(), size_t(8192));
+
+    // ...until shrink_to_fit() frees it, which it only does once nothing is buffered
+    stream.shrink_to_fit();
+    test_should_be(stream.allocated_ring_size(), size_t(8192));
+    expect_bytes(stream.read(3), "abc");
+    stream.shrink_to_fit();
+    test_should_be(stream.allocated_ring_size(), size_t(0));
+    test_should_be(stream.write("def"), size_t(3));
+    expect_bytes(stream.read(3), "def");
+}
+
+int main() {
+    try {
+        check_prepare_commit(ByteStream::Storage::Ring);
+        check_prepare_commit(ByteStream::Storage::Chunked);
+        check_prepare_commit(ByteStream::Storage::Mirrored);
+        check_write_at(ByteStream::Storage::Ring);
+        check_write_at(ByteStream::Storage::Mirrored);
+        check_grow_capacity(ByteStream::Storage::Ring);
+        check_grow_capacity(ByteStream::Storage::Mirrored);
+        check_ring_reuse();
+
+        ByteStream chunked{16, ByteStream::Storage::Chunked};
+        test_should_be(chunked.write_at(0, "abc"), size_t(0));
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
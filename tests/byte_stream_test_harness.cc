@@ -45,11 +45,13 @@ void ByteStreamAction::execute(ByteStream &) const {}
 
 ByteStreamAction::~ByteStreamAction() {}
 
-ByteStreamTestHarness::ByteStreamTestHarness(const std::string &test_name, const size_t capacity)
-    : _test_name(test_name), _byte_stream(capacity) {
+ByteStreamTestHarness::ByteStreamTestHarness(const std::string &test_name,
+                                             const size_t capacity,
+                                             const ByteStream::Storage storage)
+    : _test_name(test_name), _byte_stream(capacity, storage) {
     std::ostringstream ss;
     ss << "Initialized with ("
-       << "capacity=" << capacity << ")";
+       << "capacity=" << capacity << (storage == ByteStream::Storage::Chunked ? ", chunked" : "") << ")";
     _steps_executed.emplace_back(ss.str());
 }
 
@@ -102,6 +104,17 @@ Pop::Pop(const size_t len) : _len(len) {}
 std::string Pop::description() const { return "pop " + to_string(_len); }
 void Pop::execute(ByteStream &bs) const { bs.pop_output(_len); }
 
+// ReadBuffer
+ReadBuffer::ReadBuffer(const std::string &output) : _output(output) {}
+std::string ReadBuffer::description() const { return "read_buffer " + to_string(_output.size()); }
+void ReadBuffer::execute(ByteStream &bs) const {
+    const Buffer output = bs.read_buffer(_output.size());
+    if (output.str() != _output) {
+        throw ByteStreamExpectationViolation("Expected to read \"" + _output + "\" into a Buffer, but read \"" +
+                                             output.copy() + "\"");
+    }
+}
+
 // InputEnded
 InputEnded::InputEnded(const bool input_ended) : _input_ended(input_ended) {}
 std::string InputEnded::description() const { return "input_ended: " + to_string(_input_ended); }
@@ -182,3 +195,23 @@ void Peek::execute(ByteStream &bs) const {
                                              output + "\"");
     }
 }
+
+// PeekView
+PeekView::PeekView(const std::string &output, const size_t n_views) : _output(output), _n_views(n_views) {}
+std::string PeekView::description() const {
+    return "\"" + _output + "\" in " + to_string(_n_views) + " view(s) at the front of the stream";
+}
+void PeekView::execute(ByteStream &bs) const {
+    const auto iovecs = bs.peek_output_view(_output.size()).as_iovecs();
+    std::string output;
+    for (const auto &iov : iovecs) {
+        output.append(static_cast<const char *>(iov.iov_base), iov.iov_len);
+    }
+    if (output != _output) {
+        throw ByteStreamExpectationViolation("Expected \"" + _output + "\" at the front of the stream, but viewed \"" +
+                                             output + "\"");
+    }
+    if (iovecs.size() != _n_views) {
+        throw ByteStreamExpectationViolation::property("number of views", _n_views, iovecs.size());
+    }
+}
@@ -64,6 +64,14 @@ struct Pop : public ByteStreamAction {
     void execute(ByteStream &) const override;
 };
 
+struct ReadBuffer : public ByteStreamAction {
+    std::string _output;
+
+    ReadBuffer(const std::string &output);
+    std::string description() const override;
+    void execute(ByteStream &) const override;
+};
+
 struct InputEnded : public ByteStreamExpectation {
     bool _input_ended;
 
@@ -128,13 +136,24 @@ struct Peek : public ByteStreamExpectation {
     void execute(ByteStream &) const override;
 };
 
+struct PeekView : public ByteStreamExpectation {
+    std::string _output;
+    size_t _n_views;
+
+    PeekView(const std::string &output, const size_t n_views);
+    std::string description() const override;
+    void execute(ByteStream &) const override;
+};
+
 class ByteStreamTestHarness {
     std::string _test_name;
     ByteStream _byte_stream;
     std::vector<std::string> _steps_executed{};
 
   public:
-    ByteStreamTestHarness(const std::string &test_name, const size_t capacity);
+    ByteStreamTestHarness(const std::string &test_name,
+                          const size_t capacity,
+                          const ByteStream::Storage storage = ByteStream::Storage::Ring);
 
     void execute(const ByteStreamTestStep &step);
 };
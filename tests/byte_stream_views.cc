@@ -0,0 +1,83 @@
+#include "byte_stream.hh"
+#include "byte_stream_test_harness.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            ByteStreamTestHarness test{"view-contiguous", 8};
+
+            test.execute(Write{"cat"});
+            test.execute(PeekView{"cat", 1});
+            test.execute(PeekView{"ca", 1});
+            test.execute(BufferSize{3});
+
+            test.execute(ReadBuffer{"cat"});
+
+            test.execute(BufferEmpty{true});
+            test.execute(BytesRead{3});
+            test.execute(RemainingCapacity{8});
+        }
+
+        {
+            ByteStreamTestHarness test{"view-wraparound", 8};
+
+            test.execute(Write{"abcdef"});
+            test.execute(Pop{4});
+            test.execute(Write{"ghijk"});
+
+            test.execute(BufferSize{7});
+            test.execute(RemainingCapacity{1});
+            test.execute(PeekView{"efghijk", 2});
+            test.execute(PeekView{"efgh", 1});
+            test.execute(PeekView{"efghi", 2});
+            test.execute(PeekView{"ef", 1});
+            test.execute(Peek{"efghijk"});
+
+            test.execute(ReadBuffer{"efghi"});
+
+            test.execute(BytesRead{9});
+            test.execute(BytesWritten{11});
+            test.execute(PeekView{"jk", 1});
+        }
+
+        {
+            ByteStreamTestHarness test{"view-mirrored-wraparound", 4096, ByteStream::Storage::Mirrored};
+
+            test.execute(Write{string(4090, 'x')});
+            test.execute(Pop{4090});
+            test.execute(Write{"abcdefghij"});
+
+            test.execute(BufferSize{10});
+            test.execute(PeekView{"abcdefghij", 1});
+            test.execute(PeekView{"abcdefg", 1});
+
+            test.execute(ReadBuffer{"abcdefgh"});
+
+            test.execute(BytesRead{4098});
+            test.execute(PeekView{"ij", 1});
+        }
+
+        {
+            ByteStreamTestHarness test{"read-buffer-short", 4};
+
+            test.execute(Write{"ab"});
+            test.execute(EndInput{});
+            test.execute(ReadBuffer{"ab"});
+            test.execute(ReadBuffer{""});
+
+            test.execute(Eof{true});
+            test.execute(BytesRead{2});
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+#include "byte_stream.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+static void check_watermarks(const ByteStream::Storage storage) {
+    ByteStream stream{16, storage};
+    int lows = 0;
+    int highs = 0;
+    stream.set_low_watermark(2, [&] { ++lows; });
+    stream.set_high_watermark(8, [&] { ++highs; });
+
+    // rising below the high watermark, then crossing it once
+    stream.write("abcd");
+    test_should_be(highs, 0);
+    stream.write("efgh");
+    test_should_be(highs, 1);
+    stream.write("ij");
+    test_should_be(highs, 1);
+
+    // falling below the high watermark doesn't fire the low one until it is crossed
+    stream.pop_output(5);
+    test_should_be(lows, 0);
+    stream.pop_output(3);
+    test_should_be(lows, 1);
+    stream.pop_output(2);
+    test_should_be(lows, 1);
+
+    // a single write can cross the high watermark from empty
+    stream.write(string(12, 'x'));
+    test_should_be(highs, 2);
+    stream.pop_output(16);
+    test_should_be(lows, 2);
+
+    // an empty callback stops notifications
+    stream.set_high_watermark(1, {});
+    stream.write("y");
+    test_should_be(highs, 2);
+    test_should_be(stream.buffer_size(), size_t(1));
+}
+
+int main() {
+    try {
+        check_watermarks(ByteStream::Storage::Ring);
+        check_watermarks(ByteStream::Storage::Chunked);
+        check_watermarks(ByteStream::Storage::Mirrored);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
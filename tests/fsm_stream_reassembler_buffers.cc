@@ -0,0 +1,83 @@
+#include "byte_stream.hh"
+#include "fsm_stream_reassembler_harness.hh"
+#include "stream_reassembler.hh"
+#include "util.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+int main() {
+    try {
+        for (const auto storage : {ByteStream::Storage::Ring, ByteStream::Storage::Chunked}) {
+            {
+                ReassemblerTestHarness test{65000, storage};
+
+                test.execute(SubmitBuffers{{"cd"}, 2});
+                test.execute(BytesAssembled(0));
+                test.execute(UnassembledBytes(2));
+
+                test.execute(SubmitBuffers{{"ab", "c", "def"}, 0});
+                test.execute(BytesAssembled(6));
+                test.execute(BytesAvailable("abcdef"));
+                test.execute(UnassembledBytes(0));
+                test.execute(NotAtEof{});
+            }
+
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                // overlapping buffers, trimmed to the window and to what is already stored
+                test.execute(SubmitBuffers{{"efgh", "ijkl"}, 4});
+                test.execute(UnassembledBytes(4));
+                test.execute(SubmitBuffers{{"cdefg"}, 2});
+                test.execute(UnassembledBytes(6));
+                test.execute(SubmitBuffers{{"a", "bc"}, 0});
+                test.execute(BytesAssembled(8));
+                test.execute(BytesAvailable("abcdefgh"));
+
+                test.execute(SubmitBuffers{{"ij", "kl"}, 8}.with_eof(true));
+                test.execute(BytesAssembled(12));
+                test.execute(BytesAvailable("ijkl"));
+                test.execute(AtEof{});
+            }
+
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                // the batch is stored first, then written in one pass
+                test.execute(SubmitBatch{{{"gh", 6, true}, {"cd", 2, false}, {"ab", 0, false}, {"ef", 4, false}}});
+                test.execute(BytesAssembled(8));
+                test.execute(UnassembledBytes(0));
+                test.execute(BytesAvailable("abcdefgh"));
+                test.execute(AtEof{});
+            }
+
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitBatch{{{"efgh", 4, false}, {"bcd", 1, false}}});
+                test.execute(BytesAssembled(0));
+                test.execute(UnassembledBytes(7));
+                test.execute(SubmitBatch{{{"a", 0, false}, {"ijk", 8, true}}});
+                test.execute(BytesAssembled(8));
+                test.execute(BytesAvailable("abcdefgh"));
+                test.execute(NotAtEof{});
+            }
+
+            {
+                ReassemblerTestHarness test{8, storage};
+
+                test.execute(SubmitBuffers{{}, 0}.with_eof(true));
+                test.execute(BytesAssembled(0));
+                test.execute(AtEof{});
+            }
+        }
+    } catch (const exception &e) {
+        cerr << "Exception: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
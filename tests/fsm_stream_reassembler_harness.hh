@@ -9,7 +9,9 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 class ReassemblerExpectationViolation : public std::runtime_error {
   public:
@@ -159,12 +161,72 @@ struct SubmitSegment : public ReassemblerAction {
     void execute(StreamReassembler &reassembler) const { reassembler.push_substring(_data, _index, _eof); }
 };
 
+//! Submits the concatenation of `pieces` as a BufferList, or as a single Buffer if there is one piece
+struct SubmitBuffers : public ReassemblerAction {
+    std::vector<std::string> _pieces;
+    size_t _index;
+    bool _eof{false};
+
+    SubmitBuffers(std::vector<std::string> pieces, size_t index) : _pieces(pieces), _index(index) {}
+
+    SubmitBuffers &with_eof(bool eof) {
+        _eof = eof;
+        return *this;
+    }
+
+    std::string description() const {
+        std::ostringstream ss;
+        ss << "buffers submitted with data";
+        for (const std::string &piece : _pieces) {
+            ss << " \"" << piece << "\"";
+        }
+        ss << ", index `" << _index << "`, eof `" << std::to_string(_eof) << "`";
+        return ss.str();
+    }
+
+    void execute(StreamReassembler &reassembler) const {
+        if (_pieces.size() == 1) {
+            reassembler.push_substring(Buffer(std::string(_pieces.front())), _index, _eof);
+            return;
+        }
+        BufferList buffers;
+        for (const std::string &piece : _pieces) {
+            buffers.append(BufferList(std::string(piece)));
+        }
+        reassembler.push_substring(buffers, _index, _eof);
+    }
+};
+
+//! Submits several (data, index, eof) excerpts with a single call to push_substrings
+struct SubmitBatch : public ReassemblerAction {
+    std::vector<StreamReassembler::Excerpt> _excerpts{};
+
+    SubmitBatch(std::vector<std::tuple<std::string, size_t, bool>> excerpts) {
+        for (auto &[data, index, eof] : excerpts) {
+            _excerpts.push_back({Buffer(std::move(data)), index, eof});
+        }
+    }
+
+    std::string description() const {
+        std::ostringstream ss;
+        ss << "batch submitted with";
+        for (const auto &excerpt : _excerpts) {
+            ss << " (\"" << excerpt.data.str() << "\", `" << excerpt.index << "`, `" << std::to_string(excerpt.eof)
+               << "`)";
+        }
+        return ss.str();
+    }
+
+    void execute(StreamReassembler &reassembler) const { reassembler.push_substrings(_excerpts); }
+};
+
 class ReassemblerTestHarness {
     StreamReassembler reassembler;
     std::vector<std::string> steps_executed;
 
   public:
-    ReassemblerTestHarness(const size_t capacity) : reassembler(capacity), steps_executed() {
+    ReassemblerTestHarness(const size_t capacity, const ByteStream::Storage storage = ByteStream::Storage::Ring)
+        : reassembler(capacity, storage), steps_executed() {
         steps_executed.emplace_back("Initialized (capacity = " + std::to_string(capacity) + ")");
     }
 
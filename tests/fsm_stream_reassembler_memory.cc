@@ -0,0 +1,107 @@
+#include "byte_stream.hh"
+#include "stream_reassembler.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// A 40-byte slice of a 64 KiB allocation, like a small payload in a datagram read into a big buffer.
+static Buffer small_slice(const char c) {
+    Buffer slice{string(65536, c)};
+    slice.remove_suffix(65536 - 40);
+    return slice;
+}
+
+int main() {
+    try {
+        {
+            StreamReassembler reassembler{65000, ByteStream::Storage::Chunked};
+
+            // a mostly-wasted allocation is copied out rather than pinned
+            reassembler.push_substring(small_slice('b'), 40, false);
+            test_should_be(reassembler.unassembled_bytes(), size_t(40));
+            test_should_be(reassembler.resident_bytes(), size_t(40));
+
+            // a well-used allocation is kept by reference
+            reassembler.push_substring(Buffer(string(100, 'c')), 80, false);
+            test_should_be(reassembler.unassembled_bytes(), size_t(140));
+            test_should_be(reassembler.resident_bytes(), size_t(140));
+
+            reassembler.push_substring(small_slice('a'), 0, false);
+            test_should_be(reassembler.stream_out().buffer_size(), size_t(180));
+            test_should_be(reassembler.unassembled_bytes(), size_t(0));
+            test_should_be(reassembler.resident_bytes(), size_t(0));
+        }
+
+        {
+            StreamReassembler reassembler{65000, ByteStream::Storage::Chunked};
+
+            // in-order bytes are copied out of a mostly-wasted allocation too, before the output keeps them
+            const Buffer slice = small_slice('a');
+            reassembler.push_substring(slice, 0, false);
+            test_should_be(reassembler.stream_out().buffer_size(), size_t(40));
+            const auto views = reassembler.stream_out().peek_output_view(40).as_iovecs();
+            test_should_be(views.size(), size_t(1));
+            test_should_be(views.front().iov_base == slice.str().data(), false);
+
+            // while a well-used one is still shared
+            const Buffer whole{string(100, 'b')};
+            reassembler.push_substring(whole, 40, false);
+            test_should_be(reassembler.stream_out().peek_output_view(140).as_iovecs().back().iov_base ==
+                               whole.str().data(),
+                           true);
+        }
+
+        {
+            StreamReassembler reassembler{65000, ByteStream::Storage::Chunked, 250};
+
+            reassembler.push_substring(Buffer(string(100, 'b')), 100, false);
+            reassembler.push_substring(Buffer(string(100, 'd')), 300, false);
+            test_should_be(reassembler.resident_bytes(), size_t(200));
+
+            // over budget: the segment furthest ahead of the stream is dropped
+            reassembler.push_substring(Buffer(string(100, 'c')), 200, false);
+            test_should_be(reassembler.unassembled_bytes(), size_t(200));
+            test_should_be(reassembler.resident_bytes(), size_t(200));
+
+            reassembler.push_substring(Buffer(string(100, 'a')), 0, false);
+            test_should_be(reassembler.stream_out().buffer_size(), size_t(300));
+            test_should_be(reassembler.unassembled_bytes(), size_t(0));
+
+            // the dropped bytes are accepted again once they are retransmitted
+            reassembler.push_substring(Buffer(string(100, 'd')), 300, true);
+            test_should_be(reassembler.stream_out().buffer_size(), size_t(400));
+            test_should_be(reassembler.stream_out().input_ended(), true);
+        }
+
+        {
+            StreamReassembler reassembler{65000, ByteStream::Storage::Ring, 250};
+
+            // bytes dropped over budget no longer hold the output's ring once it drains and is shrunk
+            reassembler.push_substring(string(100, 'b'), 100, false);
+            reassembler.push_substring(string(100, 'd'), 300, false);
+            reassembler.push_substring(string(100, 'c'), 200, false);
+            test_should_be(reassembler.unassembled_bytes(), size_t(200));
+            reassembler.push_substring(string(100, 'a'), 0, false);
+            const string expected = string(100, 'a') + string(100, 'b') + string(100, 'c');
+            test_should_be(reassembler.stream_out().read(300) == expected, true);
+            test_should_be(reassembler.stream_out().allocated_ring_size() > 0, true);
+            reassembler.stream_out().shrink_to_fit();
+            test_should_be(reassembler.stream_out().allocated_ring_size(), size_t(0));
+
+            // and neither do discarded ones
+            reassembler.push_substring(string(100, 'e'), 400, false);
+            test_should_be(reassembler.stream_out().allocated_ring_size() > 0, true);
+            reassembler.discard_unassembled();
+            test_should_be(reassembler.stream_out().allocated_ring_size(), size_t(0));
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -2,6 +2,7 @@
 #define SPONGE_RECEIVER_HARNESS_HH
 
 #include "byte_stream.hh"
+#include "tcp_config.hh"
 #include "tcp_receiver.hh"
 #include "tcp_state.hh"
 #include "util.hh"
@@ -84,6 +85,22 @@ struct ExpectWindow : public ReceiverExpectation {
     }
 };
 
+struct ExpectCapacity : public ReceiverExpectation {
+    size_t _capacity;
+
+    ExpectCapacity(const size_t capacity) : _capacity(capacity) {}
+    std::string description() const { return "capacity " + std::to_string(_capacity); }
+
+    void execute(TCPReceiver &receiver) const {
+        if (receiver.capacity() != _capacity or receiver.stream_out().capacity() != _capacity) {
+            throw ReceiverExpectationViolation("The TCPReceiver reported capacity `" +
+                                               std::to_string(receiver.capacity()) + "` (stream capacity `" +
+                                               std::to_string(receiver.stream_out().capacity()) +
+                                               "`), but it was expected to be `" + std::to_string(_capacity) + "`");
+        }
+    }
+};
+
 struct ExpectUnassembledBytes : public ReceiverExpectation {
     size_t _n_bytes;
 
@@ -174,6 +191,47 @@ struct ReceiverAction : public ReceiverTestStep {
     virtual ~ReceiverAction() {}
 };
 
+struct AdvertiseWindow : public ReceiverAction {
+    size_t _max_window{TCPConfig::MAX_WINDOW};
+    std::optional<size_t> _window{};
+
+    AdvertiseWindow &with_max_window(const size_t max_window) {
+        _max_window = max_window;
+        return *this;
+    }
+
+    AdvertiseWindow &with_window(const size_t window) {
+        _window = window;
+        return *this;
+    }
+
+    std::string description() const {
+        std::ostringstream ss;
+        ss << "window advertised (max " << _max_window << ")";
+        if (_window.has_value()) {
+            ss << " as " << _window.value();
+        }
+        return ss.str();
+    }
+
+    void execute(TCPReceiver &receiver) const {
+        const size_t window = receiver.advertise_window(_max_window);
+        if (_window.has_value() and window != _window.value()) {
+            throw ReceiverExpectationViolation("The TCPReceiver advertised window `" + std::to_string(window) +
+                                               "`, but it was expected to be `" + std::to_string(_window.value()) +
+                                               "`");
+        }
+    }
+};
+
+struct Tick : public ReceiverAction {
+    size_t _ms;
+
+    Tick(const size_t ms) : _ms(ms) {}
+    std::string description() const { return std::to_string(_ms) + " ms pass"; }
+    void execute(TCPReceiver &receiver) const { receiver.tick(_ms); }
+};
+
 struct SegmentArrives : public ReceiverAction {
     enum class Result { NOT_SYN, OK };
 
@@ -304,6 +362,13 @@ class TCPReceiverTestHarness {
            << "capacity=" << capacity << ")";
         steps_executed.emplace_back(ss.str());
     }
+    TCPReceiverTestHarness(const TCPConfig &config) : receiver(config), steps_executed() {
+        std::ostringstream ss;
+        ss << "Initialized with ("
+           << "capacity=" << config.recv_capacity << ", capacity_max=" << config.recv_capacity_max
+           << (config.recv_memory_accountant ? ", with a memory accountant" : "") << ")";
+        steps_executed.emplace_back(ss.str());
+    }
     void execute(const ReceiverTestStep &step) {
         try {
             step.execute(receiver);
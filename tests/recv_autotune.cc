@@ -0,0 +1,59 @@
+#include "receiver_harness.hh"
+#include "tcp_config.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        TCPConfig config;
+        config.recv_capacity = 1000;
+        config.recv_capacity_max = 3000;
+
+        TCPReceiverTestHarness test{config};
+        test.execute(SegmentArrives{}.with_syn().with_seqno(0).with_result(SegmentArrives::Result::OK));
+        test.execute(Tick{40});
+        test.execute(SegmentArrives{}.with_seqno(1).with_data(string(1000, 'x')));  // the first window took 40 ms
+
+        // the reader drained a whole window in a round trip: offer twice as much
+        test.execute(ExpectBytes{string(1000, 'x')});
+        test.execute(Tick{10});
+        test.execute(ExpectCapacity{2000});
+        test.execute(ExpectWindow{2000});
+
+        // a reader that keeps up with less doesn't shrink the capacity
+        test.execute(SegmentArrives{}.with_seqno(1001).with_data(string(500, 'x')));
+        test.execute(Tick{40});
+        test.execute(ExpectBytes{string(500, 'x')});
+        test.execute(Tick{40});
+        test.execute(ExpectCapacity{2000});
+
+        // growth stops at recv_capacity_max
+        test.execute(SegmentArrives{}.with_seqno(1501).with_data(string(1500, 'x')));
+        test.execute(ExpectBytes{string(1500, 'x')});
+        test.execute(Tick{45});
+        test.execute(ExpectCapacity{3000});
+        test.execute(SegmentArrives{}.with_seqno(3001).with_data(string(3000, 'x')));
+        test.execute(ExpectBytes{string(3000, 'x')});
+        test.execute(Tick{45});
+        test.execute(ExpectCapacity{3000});
+
+        // without recv_capacity_max, the capacity is fixed
+        TCPReceiverTestHarness fixed{1000};
+        fixed.execute(SegmentArrives{}.with_syn().with_seqno(0).with_result(SegmentArrives::Result::OK));
+        fixed.execute(Tick{40});
+        fixed.execute(SegmentArrives{}.with_seqno(1).with_data(string(1000, 'x')));
+        fixed.execute(ExpectBytes{string(1000, 'x')});
+        fixed.execute(Tick{40});
+        fixed.execute(ExpectCapacity{1000});
+        fixed.execute(ExpectWindow{1000});
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#include "receiver_harness.hh"
+#include "tcp_config.hh"
+#include "tcp_memory_accountant.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        auto accountant = make_shared<TCPMemoryAccountant>(1000, 500);
+        TCPConfig config;
+        config.recv_capacity = 1000;
+        config.recv_memory_accountant = accountant;
+
+        TCPReceiverTestHarness first{config};
+        first.execute(SegmentArrives{}.with_syn().with_seqno(0).with_result(SegmentArrives::Result::OK));
+        first.execute(AdvertiseWindow{});
+        first.execute(ExpectWindow{1000});
+
+        // under pressure, a receiver offers half of its free space, but never takes back what it advertised
+        first.execute(SegmentArrives{}.with_seqno(1).with_data(string(600, 'x')));
+        test_should_be(accountant->charged(), size_t(600));
+        test_should_be(accountant->pressure() == TCPMemoryAccountant::Pressure::Moderate, true);
+        first.execute(ExpectWindow{400});
+
+        {
+            TCPReceiverTestHarness second{config};
+            second.execute(SegmentArrives{}.with_syn().with_seqno(0).with_result(SegmentArrives::Result::OK));
+            second.execute(AdvertiseWindow{});
+            second.execute(ExpectWindow{500});
+
+            second.execute(SegmentArrives{}.with_seqno(601).with_data(string(100, 'y')));
+            second.execute(ExpectUnassembledBytes{100});
+            test_should_be(accountant->charged(), size_t(700));
+
+            // exhausting the budget drops the out-of-order bytes
+            second.execute(SegmentArrives{}.with_seqno(1).with_data(string(300, 'x')));
+            second.execute(ExpectUnassembledBytes{0});
+            test_should_be(accountant->charged(), size_t(900));
+            second.execute(ExpectWindow{350});
+            second.execute(AdvertiseWindow{});
+
+            // once exhausted, no new window is opened, but what was advertised stays open
+            second.execute(SegmentArrives{}.with_seqno(301).with_data(string(100, 'x')));
+            test_should_be(accountant->pressure() == TCPMemoryAccountant::Pressure::Critical, true);
+            second.execute(ExpectWindow{250});
+            first.execute(ExpectWindow{400});
+
+            // reading frees memory for every receiver, as soon as the next window is advertised
+            first.execute(ExpectBytes{string(600, 'x')});
+            first.execute(AdvertiseWindow{});
+            first.execute(ExpectWindow{1000});
+            test_should_be(accountant->charged(), size_t(400));
+        }
+
+        // a receiver that goes away uncharges its share
+        test_should_be(accountant->charged(), size_t(0));
+
+        // the edge held open is the one in the header, not the larger window the capacity allows
+        {
+            TCPConfig large = config;
+            large.recv_capacity = 100000;
+            large.recv_memory_accountant = make_shared<TCPMemoryAccountant>(TCPConfig::MAX_WINDOW, 1000);
+
+            TCPReceiverTestHarness test{large};
+            test.execute(SegmentArrives{}.with_syn().with_seqno(0).with_result(SegmentArrives::Result::OK));
+            test.execute(AdvertiseWindow{}.with_window(TCPConfig::MAX_WINDOW));
+            test.execute(SegmentArrives{}.with_seqno(1).with_data(string(TCPConfig::MAX_WINDOW, 'x')));
+            test.execute(ExpectWindow{0});
+        }
+
+        // without an accountant, the window is the free capacity
+        TCPReceiverTestHarness alone{1000};
+        alone.execute(SegmentArrives{}.with_syn().with_seqno(0).with_data(string(600, 'x')));
+        alone.execute(ExpectWindow{400});
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
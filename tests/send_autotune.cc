@@ -0,0 +1,76 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "wrapping_integers.hh"
+
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main() {
+    try {
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 1000;
+            cfg.send_capacity_max = 4000;
+            cfg.fixed_isn = WrappingInt32{0};
+
+            TCPSenderTestHarness test{"The outbound stream grows with what each round trip delivers", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+
+            // a writer that doesn't fill the stream doesn't need more room
+            test.execute(WriteBytes{string(500, 'x')});
+            test.execute(ExpectSegment{}.with_seqno(1).with_payload_size(500));
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(ExpectCapacity{1000});
+
+            // a writer held back by a full stream gets twice what was delivered per round trip
+            test.execute(WriteBytes{string(1500, 'x')});
+            test.execute(ExpectSegment{}.with_seqno(501).with_payload_size(1000));
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(ExpectCapacity{2000});
+
+            // up to send_capacity_max
+            test.execute(WriteBytes{string(3000, 'x')});
+            test.execute(ExpectSegments{2});
+            test.execute(ExpectBytesInFlight{2000});
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(ExpectCapacity{4000});
+            test.execute(WriteBytes{string(5000, 'x')});
+            test.execute(ExpectSegments{3});
+            test.execute(ExpectBytesInFlight{3000});
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(ExpectCapacity{4000});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 1000;
+            cfg.fixed_isn = WrappingInt32{0};
+
+            TCPSenderTestHarness test{"Without send_capacity_max, the capacity is fixed", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(WriteBytes{string(1500, 'x')});
+            test.execute(ExpectSegment{}.with_seqno(1).with_payload_size(1000));
+            test.execute(Tick{20});
+            test.execute(AckAll{3000});
+            test.execute(ExpectCapacity{1000});
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
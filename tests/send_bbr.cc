@@ -0,0 +1,34 @@
+#include "bottleneck_link.hh"
+#include "tcp_config.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+constexpr size_t BANDWIDTH = TCPConfig::MAX_PAYLOAD_SIZE;  // bytes per millisecond through the bottleneck
+constexpr size_t ONE_WAY_DELAY = 10;                       // milliseconds
+constexpr uint16_t WINDOW = 65535;                         // a little over twice the bandwidth-delay product
+
+int main() {
+    try {
+        constexpr size_t duration = 4000;
+        const BottleneckLink link{BANDWIDTH, ONE_WAY_DELAY, WINDOW, 8 * 1024 * 1024};
+        const LinkStats unlimited = link.run({TCPConfig::CongestionControl::None}, duration);
+        const LinkStats bbr = link.run({TCPConfig::CongestionControl::BBR}, duration);
+
+        // both keep the bottleneck busy...
+        test_should_be(unlimited.delivered_late[0] >= BANDWIDTH * duration / 2 * 95 / 100, true);
+        test_should_be(bbr.delivered_late[0] >= BANDWIDTH * duration / 2 * 90 / 100, true);
+
+        // ...but BBR doesn't keep a standing queue of the rest of the receiver's window
+        test_should_be(unlimited.max_queue_late >= size_t(WINDOW) - BANDWIDTH * 2 * ONE_WAY_DELAY, true);
+        test_should_be(bbr.max_queue_late < unlimited.max_queue_late / 2, true);
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace std;
+
+constexpr uint16_t WINDOW = 60000;
+constexpr uint32_t MSS = TCPConfig::MAX_PAYLOAD_SIZE;
+
+int main() {
+    try {
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 200000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.congestion_control = TCPConfig::CongestionControl::NewReno;
+
+            TCPSenderTestHarness test{"NewReno fast retransmit and recovery", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(WriteBytes{string(100000, 'x')});
+            test.execute(ExpectSegments{11});
+            test.execute(ExpectBytesInFlight{10 * MSS + 1});
+            const uint64_t ssthresh = (10 * MSS + 1) / 2;
+
+            // the third duplicate ack retransmits the oldest segment, and halves the window, inflated by
+            // the three segments that have left the network
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectSegment{}.with_seqno(1));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{ssthresh + 3 * MSS});
+
+            // further duplicates don't cut the window again, but inflate it by a segment each,
+            // which lets new data out once the window covers what is in flight
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectCongestionWindow{ssthresh + 6 * MSS});
+            test.execute(ExpectSegment{}.with_seqno(10 * MSS + 2).with_payload_size(MSS - 1));
+            test.execute(ExpectNoSegment{});
+
+            // a partial ack retransmits the next hole, and deflates the window by what it acks, but for
+            // the retransmission
+            test.execute(AckReceived{WrappingInt32{1 + MSS}}.with_win(WINDOW));
+            test.execute(ExpectSegment{}.with_seqno(1 + MSS));
+            test.execute(ExpectCongestionWindow{ssthresh + 6 * MSS});
+            test.execute(ExpectSegment{}.with_seqno(11 * MSS + 1).with_payload_size(MSS));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectConsecutiveRetransmissions{0});
+
+            // the ack that completes the repair deflates the window to ssthresh
+            test.execute(AckReceived{WrappingInt32{10 * MSS + 2}}.with_win(WINDOW));
+            test.execute(ExpectCongestionWindow{ssthresh});
+            test.execute(ExpectBytesInFlight{ssthresh});
+            test.execute(ExpectSegments{4});
+
+            // congestion avoidance: about a segment per window's worth of acks
+            test.execute(ExpectSeqno{WrappingInt32{15 * MSS + 2}});
+            test.execute(AckAll{WINDOW});
+            test.execute(ExpectCongestionWindow{ssthresh + MSS});
+            test.execute(ExpectSegments{6});
+
+            // a timeout leaves a single segment in the window
+            test.execute(Tick{TCPConfig::TIMEOUT_DFLT});
+            test.execute(ExpectSegment{}.with_seqno(15 * MSS + 2));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{MSS});
+
+            // the window then grows in slow start, and partial acks go on repairing the holes sent before
+            // the timeout, while duplicate acks for them don't count as a new loss
+            test.execute(AckReceived{WrappingInt32{16 * MSS + 2}}.with_win(WINDOW));
+            test.execute(ExpectSegment{}.with_seqno(16 * MSS + 2));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{2 * MSS});
+            for (unsigned i = 0; i < 3; i++) {
+                test.execute(AckReceived{WrappingInt32{16 * MSS + 2}}.with_win(WINDOW));
+            }
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{2 * MSS});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 200000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.congestion_control = TCPConfig::CongestionControl::Cubic;
+
+            TCPSenderTestHarness test{"Cubic fast retransmit, then growth beyond the window at the loss", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(WriteBytes{string(100000, 'x')});
+            test.execute(ExpectSegments{11});
+            test.execute(ExpectBytesInFlight{10 * MSS + 1});
+            for (unsigned i = 0; i < 3; i++) {
+                test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            }
+            test.execute(ExpectSegment{}.with_seqno(1));
+            test.execute(ExpectNoSegment{});
+            const uint64_t reduced = (10 * MSS + 1) * 7 / 10;
+            test.execute(ExpectCongestionWindow{reduced});
+            test.execute(AckAll{WINDOW});
+            test.execute(ExpectCongestionWindow{reduced});
+
+            // the window climbs back towards where the loss happened, then beyond it
+            for (unsigned round = 0; round < 30; round++) {
+                test.execute(Tick{100});
+                test.execute(AckAll{WINDOW});
+                test.execute(ExpectCongestionWindow{reduced, numeric_limits<uint64_t>::max()});
+            }
+            test.execute(ExpectCongestionWindow{10 * MSS + 2, numeric_limits<uint64_t>::max()});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 200000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.congestion_control = TCPConfig::CongestionControl::None;
+
+            TCPSenderTestHarness test{"Without congestion control, duplicate acks are ignored", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(WriteBytes{string(100000, 'x')});
+            test.execute(ExpectSegments{42});
+            test.execute(ExpectBytesInFlight{WINDOW});
+            for (unsigned i = 0; i < 3; i++) {
+                test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            }
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{numeric_limits<uint64_t>::max()});
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
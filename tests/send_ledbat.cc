@@ -0,0 +1,43 @@
+#include "bottleneck_link.hh"
+#include "tcp_config.hh"
+#include "test_should_be.hh"
+
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+constexpr size_t BANDWIDTH = TCPConfig::MAX_PAYLOAD_SIZE / 4;  // bytes per millisecond through the bottleneck
+constexpr size_t ONE_WAY_DELAY = 10;                           // milliseconds
+constexpr uint16_t WINDOW = 65535;                             // many times the bandwidth-delay product
+
+int main() {
+    try {
+        constexpr size_t duration = 4000;
+        constexpr size_t capacity_late = BANDWIDTH * duration / 2;
+        const BottleneckLink link{BANDWIDTH, ONE_WAY_DELAY, WINDOW, 2 * 1024 * 1024};
+
+        // alone, LEDBAT keeps the bottleneck busy with a queue of about its target delay...
+        {
+            const LinkStats unlimited = link.run({TCPConfig::CongestionControl::None}, duration);
+            const LinkStats ledbat = link.run({TCPConfig::CongestionControl::LEDBAT}, duration);
+            test_should_be(unlimited.delivered_late[0] >= capacity_late * 95 / 100, true);
+            test_should_be(ledbat.delivered_late[0] >= capacity_late * 90 / 100, true);
+            test_should_be(unlimited.max_queue_late >= size_t(WINDOW) - BANDWIDTH * 2 * ONE_WAY_DELAY, true);
+            test_should_be(ledbat.max_queue_late <= BANDWIDTH * 40, true);
+        }
+
+        // ...and next to a loss-based flow, which queues up all the receiver's window allows, it yields
+        {
+            const LinkStats shared =
+                link.run({TCPConfig::CongestionControl::NewReno, TCPConfig::CongestionControl::LEDBAT}, duration);
+            test_should_be(shared.delivered_late[0] >= capacity_late * 85 / 100, true);
+            test_should_be(shared.delivered_late[1] <= capacity_late * 10 / 100, true);
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+constexpr uint16_t WINDOW = 65535;
+constexpr uint64_t MSS = TCPConfig::MAX_PAYLOAD_SIZE;
+constexpr size_t RTT = 10;
+
+int main() {
+    try {
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 64000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.pacing = false;
+
+            TCPSenderTestHarness test{"Without pacing, the whole window goes in one burst", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{RTT});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(WriteBytes{string(64000, 'x')});
+            test.execute(ExpectSegments{45});
+            test.execute(ExpectPacingRate{0});
+            test.execute(ExpectTimeUntilSend{});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 64000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.pacing = true;
+
+            TCPSenderTestHarness test{"With pacing, a burst of two segments, then the rest over the round trip", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{RTT});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectPacingRate{double(WINDOW) / RTT});
+            test.execute(WriteBytes{string(64000, 'x')});
+            test.execute(ExpectSegments{2});
+            test.execute(ExpectTimeUntilSend{1, 1});
+            test.execute(FillWindow{});  // an ack, say, before the next segment is due
+            test.execute(ExpectNoSegment{});
+
+            // ticks release the rest as they come, in bursts no larger than what came due since the previous tick
+            for (size_t elapsed = 1; elapsed < RTT; elapsed++) {
+                test.execute(Tick{1});
+                test.execute(ExpectSegments{1, 6});
+                test.execute(ExpectTimeUntilSend{1, 1});
+            }
+            test.execute(Tick{1});
+            test.execute(ExpectSegments{1, 6});
+            test.execute(ExpectTimeUntilSend{});
+            test.execute(ExpectBytesInFlight{64000});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 64000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.pacing = true;
+            cfg.pacing_max_burst = 8 * MSS;
+
+            TCPSenderTestHarness test{"The burst is configurable, and late ticks catch up", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{RTT});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(WriteBytes{string(64000, 'x')});
+            test.execute(ExpectSegments{8});
+            test.execute(Tick{5});
+            test.execute(ExpectSegments{21, 23});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 64000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.pacing = true;
+
+            TCPSenderTestHarness test{"A segment released by a tick waits a whole RTO to be retransmitted", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{RTT});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(WriteBytes{string(2 * MSS, 'x')});
+            test.execute(ExpectSegments{2});
+            test.execute(AckReceived{WrappingInt32{uint32_t(1 + 2 * MSS)}}.with_win(WINDOW));
+            test.execute(ExpectBytesInFlight{0});
+            test.execute(WriteBytes{string(MSS, 'x')});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{50});
+            test.execute(ExpectSegment{}.with_seqno(uint32_t(1 + 2 * MSS)));
+            test.execute(Tick{TCPConfig::TIMEOUT_DFLT - 1});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_seqno(uint32_t(1 + 2 * MSS)));
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.send_capacity = 64000;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.pacing = true;
+            cfg.congestion_control = TCPConfig::CongestionControl::NewReno;
+
+            TCPSenderTestHarness test{"In slow start, the pace is twice the window per round trip", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{RTT});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectNoSegment{});
+            test.execute(ExpectCongestionWindow{10 * MSS + 1});
+            test.execute(ExpectPacingRate{2.0 * (10 * MSS + 1) / RTT});
+            test.execute(WriteBytes{string(64000, 'x')});
+            test.execute(ExpectSegments{2});
+            test.execute(ExpectTimeUntilSend{1, RTT});
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+#include "sender_harness.hh"
+#include "tcp_config.hh"
+#include "tcp_sender.hh"
+#include "test_should_be.hh"
+#include "wrapping_integers.hh"
+
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+constexpr uint16_t WINDOW = 60000;
+
+int main() {
+    try {
+        {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+
+            TCPSenderTestHarness test{"By default, the round trip is measured, but the timeout stays at rt_timeout",
+                                      cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectRtt{10, 5});
+            test.execute(ExpectRetransmissionTimeout{TCPConfig::TIMEOUT_DFLT});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.adaptive_rto = true;
+
+            TCPSenderTestHarness test{"Adaptive RTO follows RFC 6298", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+
+            // the first sample sets SRTT = R and RTTVAR = R/2, so RTO = SRTT + 4 * RTTVAR
+            test.execute(ExpectRtt{10, 5});
+            test.execute(ExpectRetransmissionTimeout{30});
+
+            // the timer runs for the RTO, and backs off exponentially
+            test.execute(WriteBytes{string(1000, 'x')});
+            test.execute(ExpectSegment{}.with_seqno(1).with_payload_size(1000));
+            test.execute(Tick{29});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_seqno(1).with_payload_size(1000));
+            test.execute(ExpectRetransmissionTimeout{60});
+            test.execute(Tick{59});
+            test.execute(ExpectNoSegment{});
+            test.execute(Tick{1});
+            test.execute(ExpectSegment{}.with_seqno(1).with_payload_size(1000));
+            test.execute(ExpectRetransmissionTimeout{120});
+
+            // an ack for a retransmitted segment isn't a sample (Karn), but ends the backoff
+            test.execute(AckReceived{WrappingInt32{1001}}.with_win(WINDOW));
+            test.execute(ExpectRtt{10, 5});
+            test.execute(ExpectRetransmissionTimeout{30});
+
+            // later samples move RTTVAR by a quarter of the deviation, then SRTT by an eighth
+            test.execute(WriteBytes{string(1000, 'x')});
+            test.execute(ExpectSegment{}.with_seqno(1001));
+            test.execute(Tick{20});
+            test.execute(AckReceived{WrappingInt32{2001}}.with_win(WINDOW));
+            test.execute(ExpectRtt{(7 * 10 + 20) / 8, (3 * 5 + 10) / 4});
+            test.execute(ExpectRetransmissionTimeout{35});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.adaptive_rto = true;
+            cfg.rto_min = 100;
+
+            TCPSenderTestHarness test{"The timeout is at least rto_min", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(ExpectRetransmissionTimeout{100});
+        }
+
+        {
+            TCPConfig cfg;
+            cfg.fixed_isn = WrappingInt32{0};
+            cfg.adaptive_rto = true;
+            cfg.rto_max = 50;
+
+            TCPSenderTestHarness test{"The timeout is at most rto_max, backoff included", cfg};
+
+            test.execute(ExpectSegment{}.with_syn(true).with_seqno(0));
+            test.execute(Tick{10});
+            test.execute(AckReceived{WrappingInt32{1}}.with_win(WINDOW));
+            test.execute(WriteBytes{string(1000, 'x')});
+            test.execute(Tick{30});
+            test.execute(ExpectRetransmissionTimeout{50});
+            test.execute(Tick{50});
+            test.execute(ExpectRetransmissionTimeout{50});
+            test.execute(ExpectConsecutiveRetransmissions{2});
+        }
+
+        // bounds that leave no room for the timeout are refused
+        {
+            TCPConfig cfg;
+            cfg.adaptive_rto = true;
+            cfg.rto_min = 200;
+            cfg.rto_max = 100;
+            bool refused = false;
+            try {
+                TCPSender sender{cfg};
+            } catch (const runtime_error &) {
+                refused = true;
+            }
+            test_should_be(refused, true);
+        }
+    } catch (const exception &e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
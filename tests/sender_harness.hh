@@ -15,6 +15,7 @@
 #include <optional>
 #include <sstream>
 #include <string>
+#include <utility>
 
 const unsigned int DEFAULT_TEST_WINDOW = 137;
 
@@ -99,6 +100,21 @@ struct ExpectBytesInFlight : public SenderExpectation {
     }
 };
 
+struct ExpectCapacity : public SenderExpectation {
+    size_t _capacity;
+
+    ExpectCapacity(const size_t capacity) : _capacity(capacity) {}
+    std::string description() const { return "outbound stream capacity " + std::to_string(_capacity); }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.stream_in().capacity() != _capacity) {
+            throw SenderExpectationViolation("The TCPSender's outbound stream had a capacity of " +
+                                             std::to_string(sender.stream_in().capacity()) + ", but " +
+                                             std::to_string(_capacity) + " was expected");
+        }
+    }
+};
+
 struct ExpectNoSegment : public SenderExpectation {
     ExpectNoSegment() {}
     std::string description() const { return "no (more) segments"; }
@@ -115,6 +131,143 @@ struct ExpectNoSegment : public SenderExpectation {
     }
 };
 
+struct ExpectSegments : public SenderExpectation {
+    size_t _min;
+    size_t _max;
+
+    ExpectSegments(const size_t n) : _min(n), _max(n) {}
+    ExpectSegments(const size_t min, const size_t max) : _min(min), _max(max) {}
+    std::string description() const {
+        if (_min == _max) {
+            return std::to_string(_min) + " segments sent";
+        }
+        return std::to_string(_min) + " to " + std::to_string(_max) + " segments sent";
+    }
+
+    void execute(TCPSender &, std::queue<TCPSegment> &segments) const {
+        const size_t n = segments.size();
+        segments = {};
+        if (n < _min or n > _max) {
+            throw SenderExpectationViolation("The TCPSender sent " + std::to_string(n) + " segments, but " +
+                                             description() + " was expected");
+        }
+    }
+};
+
+struct ExpectCongestionWindow : public SenderExpectation {
+    uint64_t _min;
+    uint64_t _max;
+
+    ExpectCongestionWindow(const uint64_t cwnd) : _min(cwnd), _max(cwnd) {}
+    ExpectCongestionWindow(const uint64_t min, const uint64_t max) : _min(min), _max(max) {}
+    std::string description() const {
+        if (_min == _max) {
+            return "congestion window " + std::to_string(_min);
+        }
+        return "congestion window between " + std::to_string(_min) + " and " + std::to_string(_max);
+    }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.congestion_window() < _min or sender.congestion_window() > _max) {
+            throw SenderExpectationViolation("The TCPSender reported a congestion window of " +
+                                             std::to_string(sender.congestion_window()) + ", but the " +
+                                             description() + " was expected");
+        }
+    }
+};
+
+struct ExpectConsecutiveRetransmissions : public SenderExpectation {
+    unsigned int _n;
+
+    ExpectConsecutiveRetransmissions(const unsigned int n) : _n(n) {}
+    std::string description() const { return std::to_string(_n) + " consecutive retransmissions"; }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.consecutive_retransmissions() != _n) {
+            throw SenderExpectationViolation("The TCPSender reported " +
+                                             std::to_string(sender.consecutive_retransmissions()) +
+                                             " consecutive retransmissions, but " + std::to_string(_n) +
+                                             " were expected");
+        }
+    }
+};
+
+struct ExpectRetransmissionTimeout : public SenderExpectation {
+    unsigned int _rto;
+
+    ExpectRetransmissionTimeout(const unsigned int rto) : _rto(rto) {}
+    std::string description() const { return "retransmission timeout " + std::to_string(_rto) + " ms"; }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.retransmission_timeout() != _rto) {
+            throw SenderExpectationViolation("The TCPSender reported a retransmission timeout of " +
+                                             std::to_string(sender.retransmission_timeout()) + " ms, but " +
+                                             std::to_string(_rto) + " ms was expected");
+        }
+    }
+};
+
+struct ExpectRtt : public SenderExpectation {
+    size_t _srtt;
+    size_t _rttvar;
+
+    ExpectRtt(const size_t srtt, const size_t rttvar) : _srtt(srtt), _rttvar(rttvar) {}
+    std::string description() const {
+        return "smoothed round-trip time " + std::to_string(_srtt) + " ms, variation " + std::to_string(_rttvar) +
+               " ms";
+    }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.smoothed_rtt() != _srtt or sender.rtt_variation() != _rttvar) {
+            throw SenderExpectationViolation("The TCPSender reported a smoothed round-trip time of " +
+                                             std::to_string(sender.smoothed_rtt()) + " ms, variation " +
+                                             std::to_string(sender.rtt_variation()) + " ms, but " + description() +
+                                             " was expected");
+        }
+    }
+};
+
+struct ExpectPacingRate : public SenderExpectation {
+    double _rate;
+
+    ExpectPacingRate(const double rate) : _rate(rate) {}
+    std::string description() const { return "pacing rate " + std::to_string(_rate) + " bytes/ms"; }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        if (sender.pacing_rate() != _rate) {
+            throw SenderExpectationViolation("The TCPSender reported a pacing rate of " +
+                                             std::to_string(sender.pacing_rate()) + " bytes/ms, but " +
+                                             std::to_string(_rate) + " was expected");
+        }
+    }
+};
+
+struct ExpectTimeUntilSend : public SenderExpectation {
+    std::optional<std::pair<size_t, size_t>> _range{};
+
+    ExpectTimeUntilSend() {}
+    ExpectTimeUntilSend(const size_t min_ms, const size_t max_ms) : _range(std::make_pair(min_ms, max_ms)) {}
+    std::string description() const {
+        if (not _range.has_value()) {
+            return "no segment held back by pacing";
+        }
+        return "next paced segment due in " + std::to_string(_range->first) + " to " +
+               std::to_string(_range->second) + " ms";
+    }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        const std::optional<size_t> time = sender.time_until_send();
+        if (time.has_value() != _range.has_value() or
+            (time.has_value() and (time.value() < _range->first or time.value() > _range->second))) {
+            throw SenderExpectationViolation(
+                "The TCPSender reported " +
+                (time.has_value() ? "the next paced segment due in " + std::to_string(time.value()) + " ms"
+                                  : std::string("no segment held back")) +
+                ", but " + description() + " was expected");
+        }
+    }
+};
+
 struct SenderAction : public SenderTestStep {
     operator std::string() const { return "Action:      " + description(); }
     virtual std::string description() const { return "description missing"; }
@@ -210,6 +363,27 @@ struct AckReceived : public SenderAction {
     }
 };
 
+struct FillWindow : public SenderAction {
+    FillWindow() {}
+    std::string description() const { return "fill window"; }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const { sender.fill_window(); }
+};
+
+struct AckAll : public SenderAction {
+    uint16_t _window_advertisement;
+
+    AckAll(const uint16_t win) : _window_advertisement(win) {}
+    std::string description() const {
+        return "ack of everything sent, winsize " + std::to_string(_window_advertisement);
+    }
+
+    void execute(TCPSender &sender, std::queue<TCPSegment> &) const {
+        sender.ack_received(sender.next_seqno(), _window_advertisement);
+        sender.fill_window();
+    }
+};
+
 struct Close : public SenderAction {
     Close() {}
     std::string description() const { return "close"; }
@@ -394,7 +568,7 @@ class TCPSenderTestHarness {
   public:
     TCPSenderTestHarness(const std::string &name_, TCPConfig config)
         : outbound_segments()
-        , sender(config.send_capacity, config.rt_timeout, config.fixed_isn)
+        , sender(config)
         , steps_executed()
         , name(name_) {
         sender.fill_window();